@@ -1,6 +1,32 @@
 #include <Application.h>
 
+#include <filesystem>
+
 namespace clm {
+	namespace {
+		// Next to the executable rather than in the working directory, so the cache is found
+		// however the application is started. File opens paths with the ANSI API as well.
+		std::string get_executable_relative_path(const std::string& fileName)
+		{
+			std::string modulePath(MAX_PATH, '\0');
+			while (true)
+			{
+				const DWORD length = GetModuleFileNameA(nullptr, modulePath.data(), static_cast<DWORD>(modulePath.size()));
+				if (length == 0)
+				{
+					return fileName;
+				}
+				if (length < modulePath.size())
+				{
+					modulePath.resize(length);
+					break;
+				}
+				modulePath.resize(2 * modulePath.size());
+			}
+			return std::filesystem::path{modulePath}.replace_filename(fileName).string();
+		}
+	}
+
 	Application::Application(const std::wstring& applicationName, std::uint32_t width, std::uint32_t height)
 		:
 		m_eventSystem(std::make_shared<EventSystem>()),
@@ -11,7 +37,7 @@ namespace clm {
 #else
 		m_gfx(std::make_unique<GraphicsDevice>(m_window->get_hwnd(), m_window->window_dimensions())),
 #endif
-		m_font("Bahnschrift", 500.0f)
+		m_font("Bahnschrift", 500.0f, GlyphLoading::Lazy, get_executable_relative_path("Bahnschrift.meshcache"))
 	{
 		//m_eventSystem = std::make_shared<EventSystem>();
 		//m_window = std::make_unique<Windows>(m_applicationName, width, height, m_eventSystem);
@@ -85,9 +111,11 @@ namespace clm {
 			{
 #ifdef GFX_REFAC
 #else
-				std::vector<font_triangle_t> triangles = m_font.get_triangles(m_keyboard.shift_down() ? shift_down(key) : letter);
-				std::vector<font_triangle_t> missingGlyph = m_font.get_triangles(L'\0');
-				m_gfx->draw_triangles(triangles);
+				const char32_t character = m_keyboard.shift_down() ? shift_down(key) : letter;
+				m_textVertices.clear();
+				m_textIndices.clear();
+				m_font.layout_and_tessellate(std::u32string_view{&character, 1}, point_t{0.0f, 0.0f}, m_textVertices, m_textIndices);
+				m_gfx->draw_mesh(m_textVertices, m_textIndices);
 #endif
 			}
 		}
@@ -2,6 +2,8 @@
 #define APPLICATION_BASE_H
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <optional>
 #include <format>
 
@@ -38,6 +40,9 @@ namespace clm {
 #endif
 		Keyboard_t m_keyboard;
 		Font m_font;
+		// Reused for every string that's drawn
+		std::vector<point_t> m_textVertices;
+		IndexBuffer m_textIndices;
 
 		void process_keyboard_event(const KeyboardEvent_t& keyboardEvent);
 	};
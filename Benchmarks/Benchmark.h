@@ -0,0 +1,52 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+#include <chrono>
+#include <algorithm>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+
+namespace clm::bench {
+	// Results are added up here so the compiler can't drop the work that produced them
+	inline volatile uint64_t sink = 0;
+
+	template<typename T>
+	void consume(const T& value)
+	{
+		sink = sink + static_cast<uint64_t>(value);
+	}
+
+	// Wall time of a single call, in milliseconds
+	template<typename Func>
+	double time_ms(Func&& func)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// Fastest of runs calls of func(state), with a fresh state from setup() (not timed) for every call
+	template<typename Setup, typename Func>
+	double best_of(const size_t runs, Setup&& setup, Func&& func)
+	{
+		double best = std::numeric_limits<double>::infinity();
+		for (size_t i = 0; i < runs; i++)
+		{
+			auto state = setup();
+			best = std::min(best, time_ms([&func, &state]() { func(state); }));
+		}
+		return best;
+	}
+
+	template<typename Func>
+	double best_of(const size_t runs, Func&& func)
+	{
+		double best = std::numeric_limits<double>::infinity();
+		for (size_t i = 0; i < runs; i++)
+		{
+			best = std::min(best, time_ms(func));
+		}
+		return best;
+	}
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include <array>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Endian.h>
+
+#include "Benchmark.h"
+
+namespace {
+	using namespace clm;
+
+	// The element-by-element loops the vectorized functions replaced
+	template<typename T>
+	void scalar_byteswap_copy(const byte* src, T* dest, const size_t count) noexcept
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			T value{};
+			std::memcpy(&value, src + i * sizeof(T), sizeof(T));
+			dest[i] = std::byteswap(value);
+		}
+	}
+
+	uint32_t scalar_checksum_be32(const byte* data, const size_t length) noexcept
+	{
+		uint32_t checksum = 0;
+		for (size_t i = 0; i < length; i++)
+		{
+			checksum += static_cast<uint32_t>(std::to_integer<uint8_t>(data[i])) << (8 * (3 - i % 4));
+		}
+		return checksum;
+	}
+
+	// bufferSize is the size of a single call, totalBytes what all calls of a run went through
+	void print_row(const std::string& name, const size_t bufferSize, const size_t totalBytes, const double scalarMs, const double simdMs)
+	{
+		const auto gbPerSecond = [totalBytes](const double ms) { return static_cast<double>(totalBytes) / (ms * 1.0e6); };
+		std::cout << std::format("{:<16} {:>10} {:>12.2f} {:>12.2f} {:>8.2f}x\n",
+								 name, bufferSize, gbPerSecond(scalarMs), gbPerSecond(simdMs), scalarMs / simdMs);
+	}
+}
+
+// Compares byteswap_copy and checksum_be32 with the scalar loops they replaced, on buffers from a
+// short table up to a large glyf table. Throughput is in GB/s.
+int main()
+{
+	constexpr size_t runs = 20;
+	// Enough repetitions per run that even the small buffers take a measurable time
+	constexpr size_t totalBytes = 64 * 1024 * 1024;
+
+	std::mt19937 random{42};
+	std::vector<byte> data(totalBytes + sizeof(uint32_t));
+	for (byte& b : data)
+	{
+		b = static_cast<byte>(random());
+	}
+	std::vector<uint16_t> dest16(totalBytes / sizeof(uint16_t));
+	std::vector<uint32_t> dest32(totalBytes / sizeof(uint32_t));
+
+	std::cout << std::format("{:<16} {:>10} {:>12} {:>12} {:>9}\n", "function", "bytes", "scalar GB/s", "simd GB/s", "speedup");
+	for (const size_t size : std::array<size_t, 4>{ 64, 4 * 1024, 256 * 1024, 16 * 1024 * 1024 })
+	{
+		const size_t repeats = totalBytes / size;
+		// Odd start, like the arrays inside a font table
+		const byte* src = data.data() + 1;
+
+		const double scalar16 = bench::best_of(runs, [&]() { for (size_t i = 0; i < repeats; i++) scalar_byteswap_copy(src, dest16.data(), size / sizeof(uint16_t)); });
+		const double simd16 = bench::best_of(runs, [&]() { for (size_t i = 0; i < repeats; i++) byteswap_copy(src, dest16.data(), size / sizeof(uint16_t)); });
+		print_row("byteswap 16", size, totalBytes, scalar16, simd16);
+
+		const double scalar32 = bench::best_of(runs, [&]() { for (size_t i = 0; i < repeats; i++) scalar_byteswap_copy(src, dest32.data(), size / sizeof(uint32_t)); });
+		const double simd32 = bench::best_of(runs, [&]() { for (size_t i = 0; i < repeats; i++) byteswap_copy(src, dest32.data(), size / sizeof(uint32_t)); });
+		print_row("byteswap 32", size, totalBytes, scalar32, simd32);
+
+		// Both checksums are accumulated, which also checks that they agree
+		uint32_t scalarSum = 0;
+		uint32_t simdSum = 0;
+		const double scalarChecksum = bench::best_of(runs, [&]() { for (size_t i = 0; i < repeats; i++) scalarSum += scalar_checksum_be32(src + i % 4, size - 3); });
+		const double simdChecksum = bench::best_of(runs, [&]() { for (size_t i = 0; i < repeats; i++) simdSum += checksum_be32(src + i % 4, size - 3); });
+		print_row("checksum", size, totalBytes, scalarChecksum, simdChecksum);
+		if (scalarSum != simdSum)
+		{
+			std::cerr << std::format("checksum_be32 disagrees with the scalar checksum for {} bytes\n", size);
+			return 1;
+		}
+		bench::consume(dest16[size / sizeof(uint16_t) - 1] + dest32[size / sizeof(uint32_t) - 1]);
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <Font.h>
+#include <Delaunay.h>
+#include <EarClip.h>
+
+#include "Benchmark.h"
+
+namespace {
+	using namespace clm;
+
+	// Every quadratic segment becomes curveSegments lines, so one outline can be triangulated at
+	// several sizes. Consecutive off-curve points have an implied on-curve point between them.
+	std::vector<std::vector<point_t>> flatten(const GlyphOutlineView& outline, const size_t curveSegments)
+	{
+		std::vector<std::vector<point_t>> loops{};
+		size_t start = 0;
+		for (const uint16_t contourEnd : outline.contourEnds)
+		{
+			const size_t count = static_cast<size_t>(contourEnd) + 1 - start;
+			const auto point_at = [&outline, start, count](const size_t i)
+			{
+				return point_t{static_cast<float>(outline.x[start + i % count]), static_cast<float>(outline.y[start + i % count])};
+			};
+			const auto on_curve_at = [&outline, start, count](const size_t i)
+			{
+				return outline.onCurve[start + i % count] != 0;
+			};
+			const auto midpoint = [](const point_t& p0, const point_t& p1)
+			{
+				return point_t{0.5f * (p0[0] + p1[0]), 0.5f * (p0[1] + p1[1])};
+			};
+			start = static_cast<size_t>(contourEnd) + 1;
+			if (count < 3)
+			{
+				continue;
+			}
+
+			size_t first = 0;
+			while (first < count && !on_curve_at(first))
+			{
+				first++;
+			}
+			// Without any on-curve point the walk starts at the implied one after point 0
+			const size_t begin = first < count ? first : 0;
+			std::vector<point_t> loop{};
+			point_t current = first < count ? point_at(first) : midpoint(point_at(0), point_at(1));
+			loop.push_back(current);
+			for (size_t i = begin + 1; i <= begin + count; i++)
+			{
+				if (on_curve_at(i))
+				{
+					current = point_at(i);
+					loop.push_back(current);
+					continue;
+				}
+				const point_t control = point_at(i);
+				const point_t end = on_curve_at(i + 1) ? point_at(i + 1) : midpoint(control, point_at(i + 1));
+				for (size_t s = 1; s <= curveSegments; s++)
+				{
+					const float t = static_cast<float>(s) / static_cast<float>(curveSegments);
+					const float mt = 1.0f - t;
+					loop.push_back(point_t{mt * mt * current[0] + 2.0f * mt * t * control[0] + t * t * end[0],
+										   mt * mt * current[1] + 2.0f * mt * t * control[1] + t * t * end[1]});
+				}
+				current = end;
+				if (on_curve_at(i + 1))
+				{
+					i++;
+				}
+			}
+			// The walk ends where it started
+			loop.pop_back();
+			loops.push_back(std::move(loop));
+		}
+		return loops;
+	}
+
+	struct Bucket {
+		size_t maxPoints;
+		size_t outlines = 0;
+		size_t points = 0;
+		size_t earClipFailures = 0;
+		double earClipMs = 0.0;
+		double delaunayMs = 0.0;
+	};
+}
+
+// Triangulates the printable ASCII glyphs of a font by ear clipping and with a constrained Delaunay
+// triangulation, with the curves split into 1 to 16 segments. Outlines are grouped by point count,
+// which is what Font::triangulate_glyph decides on (it ear clips up to 256 points).
+// Usage: EarClipping [font name or .ttf path]
+int main(int argc, char** argv)
+{
+	const std::string fontName = argc > 1 ? argv[1] : "arial";
+	constexpr size_t runs = 5;
+
+	Font font{fontName, 72.0f};
+	std::vector<Bucket> buckets{ {32}, {64}, {128}, {256}, {512}, {1024}, {SIZE_MAX} };
+	for (char32_t character = U'!'; character <= U'~'; character++)
+	{
+		const GlyphOutlineView outline = font.get_glyph(character);
+		for (const size_t curveSegments : std::array<size_t, 5>{ 1, 2, 4, 8, 16 })
+		{
+			const std::vector<std::vector<point_t>> loops = flatten(outline, curveSegments);
+			size_t pointCount = 0;
+			for (const std::vector<point_t>& loop : loops)
+			{
+				pointCount += loop.size();
+			}
+			if (pointCount < 3)
+			{
+				continue;
+			}
+
+			Bucket& bucket = *std::find_if(buckets.begin(), buckets.end(), [pointCount](const Bucket& b) { return pointCount <= b.maxPoints; });
+			bucket.outlines++;
+			bucket.points += pointCount;
+			if (!ear_clip(loops))
+			{
+				bucket.earClipFailures++;
+			}
+			bucket.earClipMs += bench::best_of(runs, [&loops]() { bench::consume(ear_clip(loops).has_value()); });
+			bucket.delaunayMs += bench::best_of(runs, [&loops]() { bench::consume(DelaunayMesh{loops}.get_triangle_view().size()); });
+		}
+	}
+
+	std::cout << std::format("{:>10} {:>9} {:>11} {:>12} {:>12} {:>8} {:>9}\n",
+							 "points", "outlines", "avg points", "ear clip us", "delaunay us", "speedup", "failures");
+	for (const Bucket& bucket : buckets)
+	{
+		if (bucket.outlines == 0)
+		{
+			continue;
+		}
+		const double outlines = static_cast<double>(bucket.outlines);
+		const std::string range = bucket.maxPoints == SIZE_MAX ? std::string{"more"} : std::format("<= {}", bucket.maxPoints);
+		std::cout << std::format("{:>10} {:>9} {:>11.1f} {:>12.2f} {:>12.2f} {:>7.2f}x {:>9}\n",
+								 range,
+								 bucket.outlines,
+								 static_cast<double>(bucket.points) / outlines,
+								 1000.0 * bucket.earClipMs / outlines,
+								 1000.0 * bucket.delaunayMs / outlines,
+								 bucket.delaunayMs / bucket.earClipMs,
+								 bucket.earClipFailures);
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include <array>
+#include <cmath>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Delaunay.h>
+
+#include "Benchmark.h"
+
+namespace {
+	using namespace clm;
+
+	std::vector<point_t> uniform_points(const size_t count, std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> distribution{0.0f, 1.0f};
+		std::vector<point_t> points(count);
+		for (point_t& p : points)
+		{
+			p = point_t{distribution(random), distribution(random)};
+		}
+		return points;
+	}
+
+	// A few dense clusters, like the points of a glyph's curves
+	std::vector<point_t> clustered_points(const size_t count, std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> center{0.0f, 1.0f};
+		std::normal_distribution<float> offset{0.0f, 0.01f};
+		std::vector<point_t> centers(16);
+		for (point_t& c : centers)
+		{
+			c = point_t{center(random), center(random)};
+		}
+		std::vector<point_t> points(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			const point_t& c = centers[i % centers.size()];
+			points[i] = point_t{c[0] + offset(random), c[1] + offset(random)};
+		}
+		return points;
+	}
+
+	// Points on concentric circles, which has many cocircular points
+	std::vector<point_t> circle_points(const size_t count, std::mt19937&)
+	{
+		constexpr size_t pointsPerCircle = 256;
+		std::vector<point_t> points(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			const float radius = 1.0f + static_cast<float>(i / pointsPerCircle);
+			const float angle = 2.0f * std::numbers::pi_v<float> * static_cast<float>(i % pointsPerCircle) / pointsPerCircle;
+			points[i] = point_t{radius * std::cos(angle), radius * std::sin(angle)};
+		}
+		return points;
+	}
+}
+
+// Builds Delaunay triangulations of different point sets with the Sorted and Brio insertion orders
+int main()
+{
+	constexpr size_t runs = 5;
+	using generator_t = std::function<std::vector<point_t>(size_t, std::mt19937&)>;
+	const std::array<std::pair<std::string, generator_t>, 3> pointSets{{
+		{ "uniform", uniform_points },
+		{ "clustered", clustered_points },
+		{ "circles", circle_points }
+	}};
+
+	std::cout << std::format("{:<10} {:>8} {:>11} {:>11} {:>8}\n", "points", "count", "sorted ms", "brio ms", "speedup");
+	for (const auto& [name, generator] : pointSets)
+	{
+		for (const size_t count : std::array<size_t, 3>{ 1000, 16000, 100000 })
+		{
+			std::mt19937 random{1};
+			const std::vector<point_t> points = generator(count, random);
+			const double sortedMs = bench::best_of(runs, [&points]() { bench::consume(DelaunayMesh{points, InsertionOrder::Sorted}.get_triangle_view().size()); });
+			const double brioMs = bench::best_of(runs, [&points]() { bench::consume(DelaunayMesh{points, InsertionOrder::Brio}.get_triangle_view().size()); });
+			std::cout << std::format("{:<10} {:>8} {:>11.2f} {:>11.2f} {:>7.2f}x\n", name, count, sortedMs, brioMs, sortedMs / brioMs);
+		}
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include <Delaunay.h>
+
+#include "Benchmark.h"
+
+namespace {
+	using namespace clm;
+
+	std::vector<point_t> uniform_points(const size_t count)
+	{
+		std::mt19937 random{1};
+		std::uniform_real_distribution<float> distribution{0.0f, 1.0f};
+		std::vector<point_t> points(count);
+		for (point_t& p : points)
+		{
+			p = point_t{distribution(random), distribution(random)};
+		}
+		return points;
+	}
+
+	// Rings of alternating orientation (an outline with holes with outlines in them), so the
+	// constraint insertion and the exterior removal get their share of adjacency lookups
+	std::vector<std::vector<point_t>> ring_loops(const size_t count)
+	{
+		constexpr size_t pointsPerLoop = 200;
+		std::vector<std::vector<point_t>> loops(std::max(count / pointsPerLoop, size_t{1}));
+		for (size_t i = 0; i < loops.size(); i++)
+		{
+			const float radius = 1.0f + static_cast<float>(i);
+			const float direction = i % 2 == 0 ? -1.0f : 1.0f;
+			for (size_t j = 0; j < pointsPerLoop; j++)
+			{
+				const float angle = direction * 2.0f * std::numbers::pi_v<float> * static_cast<float>(j) / pointsPerLoop;
+				loops[i].push_back(point_t{radius * std::cos(angle), radius * std::sin(angle)});
+			}
+		}
+		return loops;
+	}
+}
+
+// Builds Delaunay meshes to compare the triangle adjacency representations. The benchmark is
+// built twice: MeshAdjacency with the neighbor arrays, MeshAdjacencyHashMap with
+// USE_TRIANGLE_NEIGHBORS=0 (the edge to triangle hash map).
+int main()
+{
+	constexpr size_t runs = 5;
+
+	std::cout << std::format("adjacency: {}\n", USE_TRIANGLE_NEIGHBORS ? "neighbor arrays" : "edge hash map");
+	std::cout << std::format("{:>8} {:>12} {:>12} {:>12} {:>12}\n", "points", "sorted ms", "brio ms", "loops", "loops ms");
+	for (const size_t count : std::array<size_t, 3>{ 1000, 16000, 100000 })
+	{
+		const std::vector<point_t> points = uniform_points(count);
+		const std::vector<std::vector<point_t>> loops = ring_loops(count);
+		const double sortedMs = bench::best_of(runs, [&points]() { bench::consume(DelaunayMesh{points, InsertionOrder::Sorted}.get_triangle_view().size()); });
+		const double brioMs = bench::best_of(runs, [&points]() { bench::consume(DelaunayMesh{points, InsertionOrder::Brio}.get_triangle_view().size()); });
+		const double loopsMs = bench::best_of(runs, [&loops]() { bench::consume(DelaunayMesh{loops, InsertionOrder::Brio}.get_triangle_view().size()); });
+		std::cout << std::format("{:>8} {:>12.2f} {:>12.2f} {:>12} {:>12.2f}\n", count, sortedMs, brioMs, loops.size(), loopsMs);
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include <array>
+#include <format>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <Font.h>
+#include <ThreadPool.h>
+
+#include "Benchmark.h"
+
+// Triangulates the Latin glyphs (U+0020 to U+024F) of a font with Font::preload on 1 to 16 threads.
+// Every run starts from a freshly constructed font, so nothing is cached between runs.
+// Usage: ThreadScaling [font name or .ttf path] [point size]
+int main(int argc, char** argv)
+{
+	using namespace clm;
+
+	const std::string fontName = argc > 1 ? argv[1] : "arial";
+	const float pointSize = argc > 2 ? std::stof(argv[2]) : 72.0f;
+	constexpr size_t runs = 5;
+
+	std::vector<char32_t> characters{};
+	for (char32_t character = U' '; character <= U'\u024F'; character++)
+	{
+		characters.push_back(character);
+	}
+
+	std::cout << std::format("{} at {}pt, {} characters, best of {} runs\n", fontName, pointSize, characters.size(), runs);
+	std::cout << std::format("{:>8} {:>10} {:>8}\n", "threads", "ms", "speedup");
+	double singleThreaded = 0.0;
+	for (const size_t threadCount : std::array<size_t, 5>{ 1, 2, 4, 8, 16 })
+	{
+		ThreadPool pool{threadCount};
+		const double ms = bench::best_of(runs,
+										 [&fontName, pointSize]() { return Font{fontName, pointSize}; },
+										 [&characters, &pool](Font& font) { font.preload(characters, pool); });
+		if (threadCount == 1)
+		{
+			singleThreaded = ms;
+		}
+		std::cout << std::format("{:>8} {:>10.2f} {:>7.2f}x\n", threadCount, ms, singleThreaded / ms);
+	}
+	return 0;
+}
\ No newline at end of file
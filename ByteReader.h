@@ -0,0 +1,188 @@
+#ifndef BYTE_READER_H
+#define BYTE_READER_H
+#include <string>
+#include <vector>
+#include <exception>
+#include <stdexcept>
+#include <span>
+#include <array>
+#include <algorithm>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <concepts>
+
+#include <clmUtil/clm_util.h>
+#include <clmUtil/clm_concepts_ext.h>
+#include <clmUtil/clm_err.h>
+
+#include <Endian.h>
+
+using std::byte;
+
+namespace clm {
+	// Cursor over a read-only byte range (usually a single table of a File).
+	// It only holds a pointer, bounds and the read position, so it is cheap to copy
+	// and each copy can be read from independently of the others.
+	class ByteReader {
+	public:
+		ByteReader() noexcept = default;
+		ByteReader(std::span<const byte> data, Endian dataEndian = Endian::Little, Endian requestEndian = Endian::Little) noexcept
+			:
+			m_data(data),
+			m_swapEndian(dataEndian != requestEndian)
+		{}
+		~ByteReader() noexcept = default;
+		ByteReader(const ByteReader&) noexcept = default;
+		ByteReader(ByteReader&&) noexcept = default;
+		ByteReader& operator=(const ByteReader&) noexcept = default;
+		ByteReader& operator=(ByteReader&&) noexcept = default;
+
+		size_t size() const noexcept { return m_data.size(); }
+		size_t remaining() const noexcept { return m_data.size() - m_offset; }
+		size_t get_position() const noexcept { return m_offset; }
+		void set_position(size_t offset) noexcept(util::release)
+		{
+			err::assert<std::out_of_range>(offset <= m_data.size(), "Attempting to set position beyond reader bounds");
+			m_offset = offset;
+		}
+		void skip(size_t count) noexcept(util::release)
+		{
+			set_position(m_offset + count);
+		}
+
+		// Reader over [offset, offset + length) of this reader, positioned at its start
+		ByteReader subreader(size_t offset, size_t length) const noexcept(util::release)
+		{
+			err::assert<std::out_of_range>(offset <= m_data.size() && length <= m_data.size() - offset,
+										   "Subreader goes beyond reader bounds");
+			ByteReader reader{*this};
+			reader.m_data = m_data.subspan(offset, length);
+			reader.m_offset = 0;
+			return reader;
+		}
+		ByteReader subreader(size_t offset) const noexcept(util::release)
+		{
+			err::assert<std::out_of_range>(offset <= m_data.size(), "Subreader goes beyond reader bounds");
+			return subreader(offset, m_data.size() - offset);
+		}
+
+		template<typename T>
+		void get_data_raw(T& dest) noexcept(util::release)
+		{
+			err::assert<std::runtime_error>(sizeof(T) <= remaining(), "Read request goes beyond reader bounds.");
+			std::memcpy(&dest, m_data.data() + m_offset, sizeof(T));
+			m_offset += sizeof(T);
+		}
+		template<typename T>
+		void get_data(T& dest) noexcept(util::release)
+		{
+			get_data_raw(dest);
+			if (m_swapEndian)
+			{
+				change_endian(dest);
+			}
+		}
+		template<typename T>
+		T get_data() noexcept(util::release)
+		{
+			T dest{};
+			get_data(dest);
+			return dest;
+		}
+		template<typename T>
+		void get_data(T* dest, size_t count) noexcept(util::release)
+		{
+			err::assert<std::runtime_error>(count * sizeof(T) <= remaining(), "Read request goes beyond reader bounds.");
+			if constexpr (std::integral<T>)
+			{
+				// Whole arrays are swapped in one go instead of element by element
+				using unsigned_t = std::make_unsigned_t<T>;
+				const byte* src = m_data.data() + m_offset;
+				if constexpr (std::same_as<unsigned_t, uint16_t> || std::same_as<unsigned_t, uint32_t>)
+				{
+					if (m_swapEndian)
+					{
+						byteswap_copy(src, reinterpret_cast<unsigned_t*>(dest), count);
+					}
+					else
+					{
+						std::memcpy(dest, src, count * sizeof(T));
+					}
+					m_offset += count * sizeof(T);
+					return;
+				}
+				else if constexpr (sizeof(T) == 1)
+				{
+					std::memcpy(dest, src, count);
+					m_offset += count;
+					return;
+				}
+			}
+			for (size_t i = 0; i < count; i++)
+			{
+				get_data(*dest);
+				dest++;
+			}
+		}
+		// Reads at offset without moving the cursor
+		template<typename T>
+		T peek(size_t offset) const noexcept(util::release)
+		{
+			ByteReader reader{*this};
+			reader.set_position(offset);
+			return reader.get_data<T>();
+		}
+		template<typename Src, typename Dest> requires util::not_same_as<Src, Dest>
+		void fill_vec(std::vector<Dest>& dest) noexcept(util::release)
+		{
+			err::assert<std::runtime_error>(sizeof(Src) * dest.size() <= remaining(), "Read request goes beyond reader bounds.");
+			// Decode in chunks through the bulk path, then widen/narrow into dest
+			constexpr size_t chunkSize = 256;
+			std::array<Src, chunkSize> chunk{};
+			size_t i = 0;
+			while (i < dest.size())
+			{
+				const size_t count = std::min(chunkSize, dest.size() - i);
+				get_data(chunk.data(), count);
+				for (size_t j = 0; j < count; j++)
+				{
+					dest[i + j] = static_cast<Dest>(chunk[j]);
+				}
+				i += count;
+			}
+		}
+		template<typename T>
+		void fill_vec(std::vector<T>& dest) noexcept(util::release)
+		{
+			get_data(dest.data(), dest.size());
+		}
+	private:
+		std::span<const byte> m_data{};
+		size_t m_offset = 0;
+		bool m_swapEndian = false;
+	};
+
+	template <std::integral T>
+	ByteReader& operator>>(ByteReader& reader, T& dest)
+	{
+		reader.get_data(dest);
+		return reader;
+	}
+
+	inline ByteReader& operator>>(ByteReader& reader, std::string& dest)
+	{
+		reader.get_data(dest.data(), dest.size());
+		return reader;
+	}
+
+	template<std::integral T>
+	ByteReader& operator>>(ByteReader& reader, std::vector<T>& dest)
+	{
+		reader.fill_vec<T>(dest);
+		return reader;
+	}
+}
+
+#endif
\ No newline at end of file
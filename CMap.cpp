@@ -0,0 +1,298 @@
+#include "CMap.h"
+
+#include <limits>
+#include <algorithm>
+#include <bit>
+
+namespace clm {
+	CMapSubtable4::CMapSubtable4(ByteReader subtableReader)
+	{
+		subtableReader >> m_format;
+		subtableReader >> m_length;
+		subtableReader >> m_language;
+		subtableReader >> m_segCountX2;
+		subtableReader >> m_searchRange;
+		subtableReader >> m_entrySelector;
+		subtableReader >> m_rangeShift;
+
+		const uint16_t segCount = m_segCountX2 >> 1;
+		if (m_format != 4 || segCount == 0)
+		{
+			throw std::runtime_error{"Malformed cmap subtable 4"};
+		}
+		// The unrolled search in find_segment relies on these being exactly what the spec says they
+		// are. Some fonts get them wrong, those are searched with a plain binary search instead.
+		const uint16_t entrySelectorCheck = static_cast<uint16_t>(std::bit_width(segCount) - 1);
+		const uint16_t searchRangeCheck = static_cast<uint16_t>(2 << entrySelectorCheck);
+		const uint16_t rangeShiftCheck = static_cast<uint16_t>(m_segCountX2 - searchRangeCheck);
+		m_validSearchFields = searchRangeCheck == m_searchRange &&
+							  entrySelectorCheck == m_entrySelector &&
+							  rangeShiftCheck == m_rangeShift;
+
+		if (subtableReader.remaining() < static_cast<size_t>(segCount) * 4 * sizeof(uint16_t) + sizeof(uint16_t))
+		{
+			throw std::runtime_error{"Overshot cmap subtable 4"};
+		}
+		m_endCodes.resize(segCount);
+		m_startCodes.resize(segCount);
+		m_idDeltas.resize(segCount);
+		m_idRangeOffsets.resize(segCount);
+
+		subtableReader >> m_endCodes;
+		subtableReader.skip(sizeof(uint16_t)); // reservedPad
+		subtableReader >> m_startCodes;
+		subtableReader >> m_idDeltas;
+		subtableReader >> m_idRangeOffsets;
+		// Whatever is left of the subtable is the glyph ID array
+		m_glyphIDArray.resize(subtableReader.remaining() / sizeof(uint16_t));
+		subtableReader >> m_glyphIDArray;
+
+		if (m_endCodes.back() != 0xFFFF)
+		{
+			throw std::runtime_error{"cmap subtable 4 is missing its final 0xFFFF segment"};
+		}
+	}
+
+	glyph_id_t CMapSubtable4::get_glyph_index(const uint16_t c) const noexcept
+	{
+		[[likely]] if (!m_lookupTable.empty())
+		{
+			return m_lookupTable[c];
+		}
+
+		return get_glyph_index_from_segment(c, find_segment(c));
+	}
+
+	void CMapSubtable4::build_lookup_table()
+	{
+		if (has_lookup_table())
+		{
+			return;
+		}
+
+		std::vector<glyph_id_t> lookupTable(static_cast<size_t>(std::numeric_limits<uint16_t>::max()) + 1, 0);
+		// The last segment is the 0xFFFF terminator and never maps anything
+		for (size_t i = 0; i + 1 < m_endCodes.size(); i++)
+		{
+			for (uint32_t c = m_startCodes[i]; c <= m_endCodes[i]; c++)
+			{
+				lookupTable[c] = get_glyph_index_from_segment(static_cast<uint16_t>(c), i);
+			}
+		}
+		m_lookupTable = std::move(lookupTable);
+	}
+
+	bool CMapSubtable4::has_lookup_table() const noexcept
+	{
+		return !m_lookupTable.empty();
+	}
+
+	size_t CMapSubtable4::find_segment(const uint16_t c) const noexcept
+	{
+		// Index of the first segment whose endCode is >= c. searchRange / 2 is the largest power of
+		// two <= segCount, so check which end of the array that window belongs at, then halve it
+		// entrySelector times.
+		if (!m_validSearchFields)
+		{
+			return static_cast<size_t>(std::lower_bound(m_endCodes.begin(), m_endCodes.end(), c) - m_endCodes.begin());
+		}
+		const size_t searchRange = m_searchRange >> 1;
+		size_t i = 0;
+		if (m_endCodes[searchRange - 1] < c)
+		{
+			i = m_rangeShift >> 1;
+		}
+		for (uint16_t k = m_entrySelector; k > 0; k--)
+		{
+			const size_t half = static_cast<size_t>(1) << (k - 1);
+			if (m_endCodes[i + half - 1] < c)
+			{
+				i += half;
+			}
+		}
+		return i;
+	}
+
+	glyph_id_t CMapSubtable4::get_glyph_index_from_segment(const uint16_t c, const size_t i) const noexcept
+	{
+		// Glyph 0 is the missing glyph
+		if (i >= m_endCodes.size() - 1 || m_startCodes[i] > c)
+		{
+			return 0;
+		}
+
+		uint16_t glyphIndex = 0;
+		if (m_idRangeOffsets[i] != 0)
+		{
+			// Determine offset into glyphIDArray
+			const size_t cOffset = static_cast<size_t>(c - m_startCodes[i]);
+			const size_t glyphIDOffset = (m_idRangeOffsets[i] >> 1) + cOffset + i;
+			if (glyphIDOffset < m_idRangeOffsets.size() ||
+				glyphIDOffset - m_idRangeOffsets.size() >= m_glyphIDArray.size())
+			{
+				return 0;
+			}
+			glyphIndex = m_glyphIDArray[glyphIDOffset - m_idRangeOffsets.size()];
+			// If the offset is not 0, then add the corresponding idDelta value modulo 65536
+			if (glyphIndex != 0)
+			{
+				glyphIndex += m_idDeltas[i];
+			}
+		}
+		else
+		{
+			glyphIndex = c + m_idDeltas[i];
+		}
+		return glyphIndex;
+	}
+
+	CMapSubtable12::CMapSubtable12(ByteReader subtableReader)
+	{
+		subtableReader >> m_format;
+		subtableReader.skip(sizeof(uint16_t)); // reserved
+		subtableReader >> m_length;
+		subtableReader >> m_language;
+		if (m_format != 12 && m_format != 13)
+		{
+			throw std::runtime_error{"Malformed cmap subtable 12/13"};
+		}
+
+		uint32_t numGroups = 0;
+		subtableReader >> numGroups;
+		if (subtableReader.remaining() / (3 * sizeof(uint32_t)) < numGroups)
+		{
+			throw std::runtime_error{"Overshot cmap subtable 12/13"};
+		}
+		m_groups.resize(numGroups);
+		for (auto& group : m_groups)
+		{
+			subtableReader >> group.startCharCode;
+			subtableReader >> group.endCharCode;
+			subtableReader >> group.startGlyphID;
+		}
+
+		// Groups are required to be sorted and non-overlapping, find_glyph_index depends on it
+		for (size_t i = 0; i < m_groups.size(); i++)
+		{
+			if (m_groups[i].startCharCode > m_groups[i].endCharCode ||
+				(i > 0 && m_groups[i - 1].endCharCode >= m_groups[i].startCharCode))
+			{
+				throw std::runtime_error{"cmap subtable 12/13 groups are not sorted"};
+			}
+		}
+	}
+
+	CMapSubtable12::CMapSubtable12(const CMapSubtable12& rhs)
+		:
+		m_format(rhs.m_format),
+		m_length(rhs.m_length),
+		m_language(rhs.m_language),
+		m_groups(rhs.m_groups)
+	{}
+
+	CMapSubtable12::CMapSubtable12(CMapSubtable12&& rhs) noexcept
+		:
+		m_format(rhs.m_format),
+		m_length(rhs.m_length),
+		m_language(rhs.m_language),
+		m_groups(std::move(rhs.m_groups))
+	{
+		rhs.clear_cache();
+	}
+
+	CMapSubtable12& CMapSubtable12::operator=(const CMapSubtable12& rhs)
+	{
+		m_format = rhs.m_format;
+		m_length = rhs.m_length;
+		m_language = rhs.m_language;
+		m_groups = rhs.m_groups;
+		clear_cache();
+		return *this;
+	}
+
+	CMapSubtable12& CMapSubtable12::operator=(CMapSubtable12&& rhs) noexcept
+	{
+		m_format = rhs.m_format;
+		m_length = rhs.m_length;
+		m_language = rhs.m_language;
+		m_groups = std::move(rhs.m_groups);
+		clear_cache();
+		rhs.clear_cache();
+		return *this;
+	}
+
+	glyph_id_t CMapSubtable12::get_glyph_index(const char32_t c) const noexcept
+	{
+		std::atomic<uint64_t>& cacheEntry = m_cache[static_cast<size_t>(c) % cacheSize];
+		const uint64_t cached = cacheEntry.load(std::memory_order_relaxed);
+		if ((cached & cacheValidBit) && ((cached & ~cacheValidBit) >> 16) == static_cast<uint64_t>(c))
+		{
+			return static_cast<glyph_id_t>(cached & 0xFFFF);
+		}
+
+		const glyph_id_t glyphIndex = find_glyph_index(c);
+		cacheEntry.store(cacheValidBit | (static_cast<uint64_t>(c) << 16) | glyphIndex, std::memory_order_relaxed);
+		return glyphIndex;
+	}
+
+	glyph_id_t CMapSubtable12::find_glyph_index(const char32_t c) const noexcept
+	{
+		// Last group starting at or before c
+		const auto groupIter = std::upper_bound(m_groups.begin(),
+												m_groups.end(),
+												static_cast<uint32_t>(c),
+												[](const uint32_t charCode, const MapGroup& group)
+												{
+													return charCode < group.startCharCode;
+												});
+		if (groupIter == m_groups.begin())
+		{
+			return 0;
+		}
+		const MapGroup& group = *(groupIter - 1);
+		if (static_cast<uint32_t>(c) > group.endCharCode)
+		{
+			return 0;
+		}
+
+		// Format 13 maps the whole range to the same glyph
+		const uint64_t glyphIndex = group.startGlyphID +
+			(m_format == 12 ? static_cast<uint64_t>(c) - group.startCharCode : 0);
+		return glyphIndex > std::numeric_limits<glyph_id_t>::max() ? 0 : static_cast<glyph_id_t>(glyphIndex);
+	}
+
+	void CMapSubtable12::clear_cache() noexcept
+	{
+		for (auto& cacheEntry : m_cache)
+		{
+			cacheEntry.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	CharacterMap::CharacterMap(CMapSubtable4&& subtable) noexcept
+		:
+		m_subtable(std::move(subtable))
+	{}
+
+	CharacterMap::CharacterMap(CMapSubtable12&& subtable) noexcept
+		:
+		m_subtable(std::move(subtable))
+	{}
+
+	glyph_id_t CharacterMap::get_glyph_index(const char32_t c) const noexcept
+	{
+		if (const CMapSubtable4* subtable = std::get_if<CMapSubtable4>(&m_subtable))
+		{
+			return c > 0xFFFF ? 0 : subtable->get_glyph_index(static_cast<uint16_t>(c));
+		}
+		return std::get<CMapSubtable12>(m_subtable).get_glyph_index(c);
+	}
+
+	void CharacterMap::build_lookup_table()
+	{
+		if (CMapSubtable4* subtable = std::get_if<CMapSubtable4>(&m_subtable))
+		{
+			subtable->build_lookup_table();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#ifndef CMAP_H
+#define CMAP_H
+#include <vector>
+#include <array>
+#include <atomic>
+#include <variant>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+
+#include <clmUtil/clm_util.h>
+
+#include <ByteReader.h>
+
+namespace clm {
+	using glyph_id_t = uint16_t;
+
+	// cmap format 4 (segment mapping to delta values), maps the BMP to glyph IDs.
+	// Lookups binary search the segments using the subtable's own searchRange/entrySelector, or
+	// std::lower_bound when the font got those wrong. build_lookup_table() additionally flattens
+	// the whole mapping into a 64K table so a lookup becomes a single load.
+	class CMapSubtable4 {
+	public:
+		CMapSubtable4() noexcept = default;
+		CMapSubtable4(ByteReader);
+		~CMapSubtable4() noexcept = default;
+		CMapSubtable4(const CMapSubtable4&) = default;
+		CMapSubtable4(CMapSubtable4&&) noexcept = default;
+		CMapSubtable4& operator=(const CMapSubtable4&) = default;
+		CMapSubtable4& operator=(CMapSubtable4&&) noexcept = default;
+
+		glyph_id_t get_glyph_index(const uint16_t) const noexcept;
+		void build_lookup_table();
+		bool has_lookup_table() const noexcept;
+	private:
+		size_t find_segment(const uint16_t) const noexcept;
+		glyph_id_t get_glyph_index_from_segment(const uint16_t, const size_t) const noexcept;
+
+		uint16_t m_format = 0;
+		uint16_t m_length = 0;
+		uint16_t m_language = 0;
+		uint16_t m_segCountX2 = 0;
+		uint16_t m_searchRange = 0;
+		uint16_t m_entrySelector = 0;
+		uint16_t m_rangeShift = 0;
+		// False when the three fields above don't match segCountX2
+		bool m_validSearchFields = false;
+		std::vector<uint16_t> m_endCodes;
+		std::vector<uint16_t> m_startCodes;
+		std::vector<int16_t> m_idDeltas;
+		std::vector<uint16_t> m_idRangeOffsets;
+		std::vector<uint16_t> m_glyphIDArray;
+
+		std::vector<glyph_id_t> m_lookupTable;
+	};
+
+	// cmap format 12 (segmented coverage) and 13 (many-to-one range mappings), covers all of
+	// Unicode. Groups are binary searched, and the most recent lookups are remembered in a small
+	// direct-mapped cache since text tends to reuse the same handful of characters.
+	class CMapSubtable12 {
+	public:
+		CMapSubtable12() noexcept = default;
+		CMapSubtable12(ByteReader);
+		~CMapSubtable12() noexcept = default;
+		CMapSubtable12(const CMapSubtable12&);
+		CMapSubtable12(CMapSubtable12&&) noexcept;
+		CMapSubtable12& operator=(const CMapSubtable12&);
+		CMapSubtable12& operator=(CMapSubtable12&&) noexcept;
+
+		glyph_id_t get_glyph_index(const char32_t) const noexcept;
+	private:
+		glyph_id_t find_glyph_index(const char32_t) const noexcept;
+		void clear_cache() noexcept;
+
+		struct MapGroup {
+			uint32_t startCharCode;
+			uint32_t endCharCode;
+			uint32_t startGlyphID;
+		};
+
+		uint16_t m_format = 0;
+		uint32_t m_length = 0;
+		uint32_t m_language = 0;
+		std::vector<MapGroup> m_groups;
+
+		// Each entry packs (codepoint << 16) | glyph ID with the top bit marking it valid, so
+		// lookups from several threads never see a torn entry
+		static constexpr size_t cacheSize = 64;
+		static constexpr uint64_t cacheValidBit = 1ull << 63;
+		mutable std::array<std::atomic<uint64_t>, cacheSize> m_cache{};
+	};
+
+	// Whichever cmap subtable the font is read through
+	class CharacterMap {
+	public:
+		CharacterMap() noexcept = default;
+		CharacterMap(CMapSubtable4&&) noexcept;
+		CharacterMap(CMapSubtable12&&) noexcept;
+
+		glyph_id_t get_glyph_index(const char32_t) const noexcept;
+		// Only format 4 has a flat lookup table, format 12 relies on its cache
+		void build_lookup_table();
+	private:
+		std::variant<CMapSubtable4, CMapSubtable12> m_subtable;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -6,106 +6,329 @@
 #include <iterator>
 #include <format>
 #include <cmath>
+#include <algorithm>
+#include <random>
+#include <bit>
+#include <numeric>
 
 #include <clmMath/clm_vector.h>
 #include <clmMath/clm_matrix.h>
 #include <clmMath/clm_geo.h>
 
 namespace clm {
-	DelaunayMesh::DelaunayMesh(const std::vector<point_t>& pointsIn)
+	namespace {
+		// Lexicographic order by (x, y)
+		bool is_before(const point_t& lhs, const point_t& rhs) noexcept
+		{
+			if (lhs[0] < rhs[0])
+			{
+				return true;
+			}
+			else if (lhs[0] > rhs[0])
+			{
+				return false;
+			}
+			else
+			{
+				return lhs[1] < rhs[1];
+			}
+		}
+	}
+
+	DelaunayMesh::DelaunayMesh(const std::vector<point_t>& pointsIn, const InsertionOrder insertionOrder)
+		:
+		DelaunayMesh()
+	{
+		insert_points(pointsIn, insertionOrder);
+		finish_triangulation();
+	}
+
+	DelaunayMesh::DelaunayMesh(const std::vector<std::vector<point_t>>& loops, const InsertionOrder insertionOrder)
 		:
 		DelaunayMesh()
+	{
+		insert_points(get_unique_points(loops), insertionOrder);
+		constrain_triangulation(loops);
+		finish_triangulation();
+	}
+
+	void DelaunayMesh::insert_points(const std::vector<point_t>& pointsIn, const InsertionOrder insertionOrder)
 	{
 		m_points.push_back({std::numeric_limits<float>::quiet_NaN(),
 						   std::numeric_limits<float>::quiet_NaN()});
 		add_points(pointsIn);
 
-		std::sort(m_points.begin() + 1, m_points.end(), [](const point_t& lhs, const point_t& rhs)
+		if (insertionOrder == InsertionOrder::Brio)
+		{
+			brio_order_points();
+		}
+		else
+		{
+			sort_points();
+		}
+
+		triangulate_points();
+	}
+
+	void DelaunayMesh::finish_triangulation()
+	{
+		// Ghost triangles are only needed while the mesh changes, afterwards the triangles are
+		// packed so they can be read without skipping any
+		for (size_t i = 0; i < get_triangle_slot_count(); i++)
+		{
+			if (is_triangle_deleted(i))
+			{
+				continue;
+			}
+			const std::array<size_t, 3> points = get_triangle_points(i);
+			if (util::disjunction(is_ghost(m_points[points[0]]),
+								  is_ghost(m_points[points[1]]),
+								  is_ghost(m_points[points[2]])))
+			{
+				delete_triangle_at(i);
+			}
+		}
+		compact_triangles();
+	}
+
+	std::vector<point_t> DelaunayMesh::get_unique_points(const std::vector<std::vector<point_t>>& loops)
+	{
+		// Loops can touch, but every point may only be inserted once
+		std::vector<point_t> points{};
+		for (const std::vector<point_t>& loop : loops)
+		{
+			points.insert(points.end(), loop.begin(), loop.end());
+		}
+		std::sort(points.begin(), points.end(), is_before);
+		points.erase(std::unique(points.begin(),
+								 points.end(),
+								 [](const point_t& lhs, const point_t& rhs)
+								 {
+									 return lhs[0] == rhs[0] && lhs[1] == rhs[1];
+								 }),
+					 points.end());
+		return points;
+	}
+
+	void DelaunayMesh::sort_points() noexcept
+	{
+		std::sort(m_points.begin() + 1, m_points.end(), is_before);
+	}
+
+	void DelaunayMesh::brio_order_points()
+	{
+		if (m_points.size() < 3)
+		{
+			return;
+		}
+
+		float xMin = std::numeric_limits<float>::max();
+		float yMin = std::numeric_limits<float>::max();
+		float xMax = std::numeric_limits<float>::lowest();
+		float yMax = std::numeric_limits<float>::lowest();
+		for (size_t i = 1; i < m_points.size(); i++)
+		{
+			xMin = std::min(xMin, m_points[i][0]);
+			yMin = std::min(yMin, m_points[i][1]);
+			xMax = std::max(xMax, m_points[i][0]);
+			yMax = std::max(yMax, m_points[i][1]);
+		}
+		constexpr uint32_t hilbertOrder = 16;
+		constexpr float gridMax = static_cast<float>((1u << hilbertOrder) - 1);
+		const float xScale = xMax > xMin ? gridMax / (xMax - xMin) : 0.0f;
+		const float yScale = yMax > yMin ? gridMax / (yMax - yMin) : 0.0f;
+		const auto hilbert_index = [](uint32_t x, uint32_t y) -> uint32_t
+		{
+			uint32_t index = 0;
+			for (uint32_t s = 1u << (hilbertOrder - 1); s > 0; s >>= 1)
+			{
+				const uint32_t rx = (x & s) > 0 ? 1 : 0;
+				const uint32_t ry = (y & s) > 0 ? 1 : 0;
+				index += s * s * ((3 * rx) ^ ry);
+				// Rotate the quadrant so the curve stays continuous
+				if (ry == 0)
+				{
+					if (rx == 1)
+					{
+						x = s - 1 - (x & (s - 1));
+						y = s - 1 - (y & (s - 1));
+					}
+					std::swap(x, y);
+				}
+			}
+			return index;
+		};
+
+		// Each point lands in the last round with probability 1/2, in the one before with 1/4 and so on
+		constexpr uint32_t maxRound = 31;
+		std::mt19937 random{0x5EED};
+		struct OrderKey {
+			uint64_t key;
+			size_t pointIndex;
+		};
+		std::vector<OrderKey> keys{};
+		keys.reserve(m_points.size() - 1);
+		for (size_t i = 1; i < m_points.size(); i++)
+		{
+			const uint32_t round = maxRound - static_cast<uint32_t>(std::countr_zero(static_cast<uint32_t>(random()) | (1u << maxRound)));
+			const uint32_t x = static_cast<uint32_t>((m_points[i][0] - xMin) * xScale);
+			const uint32_t y = static_cast<uint32_t>((m_points[i][1] - yMin) * yScale);
+			uint32_t curveIndex = hilbert_index(x, y);
+			// Every other round runs the curve backwards, so each round starts near where the last one ended
+			if (round % 2 == 1)
+			{
+				curveIndex = ~curveIndex;
+			}
+			keys.push_back({(static_cast<uint64_t>(round) << 32) | curveIndex, i});
+		}
+		std::sort(keys.begin(),
+				  keys.end(),
+				  [](const OrderKey& lhs, const OrderKey& rhs)
 				  {
-					  if (lhs[0] < rhs[0])
-					  {
-						  return true;
-					  }
-					  else if (lhs[0] > rhs[0])
-					  {
-						  return false;
-					  }
-					  else
-					  {
-						  if (lhs[1] < rhs[1])
-						  {
-							  return true;
-						  }
-						  else
-						  {
-							  return false;
-						  }
-					  }
+					  return lhs.key < rhs.key;
 				  });
 
-		triangulate_points();
+		std::vector<point_t> orderedPoints{};
+		orderedPoints.reserve(m_points.size());
+		orderedPoints.push_back(m_points[0]);
+		for (const OrderKey& key : keys)
+		{
+			orderedPoints.push_back(m_points[key.pointIndex]);
+		}
+		m_points = std::move(orderedPoints);
 	}
 
-	std::tuple<size_t, size_t, size_t> DelaunayMesh::get_enclosing_triangle(size_t p0) const noexcept(util::release)
+	size_t DelaunayMesh::get_enclosing_triangle(size_t p0) const noexcept(util::release)
 	{
-		for (const auto& triangle : m_triangles)
+		if (const std::optional<size_t> triangleIndex = walk_to_triangle(p0))
+		{
+			const std::array<size_t, 3> points = get_triangle_points(*triangleIndex);
+			if (encloses(m_points[p0],
+						 m_points[points[0]],
+						 m_points[points[1]],
+						 m_points[points[2]]))
+			{
+				return *triangleIndex;
+			}
+		}
+
+		// The walk can fail on degenerate input, every triangle is checked instead
+		for (size_t i = 0; i < get_triangle_slot_count(); i++)
 		{
-			const std::array<size_t, 3>& points = triangle.triangle.get_points();
+			if (is_triangle_deleted(i))
+			{
+				continue;
+			}
+			const std::array<size_t, 3> points = get_triangle_points(i);
 			if (encloses(m_points[p0],
 						 m_points[points[0]],
 						 m_points[points[1]],
 						 m_points[points[2]]))
 			{
-				return {points[0], points[1], points[2]};
+				return i;
 			}
 		}
 
 		throw std::runtime_error{"No enclosing triangle"};
 	}
 
-	std::optional<size_t> DelaunayMesh::get_adjacent(size_t p0,
-											 size_t p1) const noexcept(util::release)
+	std::optional<size_t> DelaunayMesh::walk_to_triangle(size_t p0) const noexcept(util::release)
 	{
-		const auto triangleIter = m_edgeTriangleMap.find({p0, p1});
-		if (triangleIter == m_edgeTriangleMap.end())
+		// Visibility walk from the last triangle that was added: cross any edge the point lies
+		// beyond until there is none, or until the walk leaves the convex hull into a ghost triangle.
+		// The first edge tested is picked at random so the walk can't cycle.
+		size_t triangleIndex = m_lastTriangle;
+		if (triangleIndex >= get_triangle_slot_count() || is_triangle_deleted(triangleIndex))
 		{
 			return {};
 		}
-		else
+		const point_t& point = m_points[p0];
+		uint32_t random = static_cast<uint32_t>(p0) * 2654435761u + 1u;
+		for (size_t step = 0; step < get_triangle_slot_count(); step++)
 		{
-			size_t triangleIndex = triangleIter->second;
-			const std::array<size_t, 3>& points = m_triangles[triangleIndex].triangle.get_points();
-			if (p0 == points[0] && p1 == points[1])
-			{
-				return {points[2]};
-			}
-			else if (p0 == points[1] && p1 == points[2])
+			const std::array<size_t, 3> points = get_triangle_points(triangleIndex);
+			const auto ghostIter = std::find_if(points.begin(),
+												points.end(),
+												[this](const size_t p)
+												{
+													return is_ghost(m_points[p]);
+												});
+			std::optional<size_t> crossedEdge{};
+			if (ghostIter != points.end())
 			{
-				return {points[0]};
+				if (step > 0 || encloses(point, m_points[points[0]], m_points[points[1]], m_points[points[2]]))
+				{
+					return {triangleIndex};
+				}
+				// Started outside of the hull, step back over the ghost triangle's real edge
+				const size_t ghost = static_cast<size_t>(ghostIter - points.begin());
+				crossedEdge = (ghost + 1) % 3;
 			}
 			else
 			{
-				if constexpr (util::release)
+				random ^= random << 13;
+				random ^= random >> 17;
+				random ^= random << 5;
+				const size_t firstEdge = random % 3;
+				for (size_t i = 0; i < 3; i++)
 				{
-					return {points[1]};
-				}
-				else
-				{
-					if (p0 == points[2] && p1 == points[0])
+					const size_t edge = (firstEdge + i) % 3;
+					if (orient2d(m_points[points[edge]], m_points[points[(edge + 1) % 3]], point) < 0.0)
 					{
-						return {points[1]};
-					}
-					else
-					{
-						throw std::runtime_error{"Triangle not found."};
+						crossedEdge = edge;
+						break;
 					}
 				}
+				if (!crossedEdge)
+				{
+					return {triangleIndex};
+				}
 			}
+
+			const std::optional<size_t> nextTriangle = get_neighbor(triangleIndex, *crossedEdge);
+			if (!nextTriangle)
+			{
+				return {};
+			}
+			triangleIndex = *nextTriangle;
 		}
+		return {};
+	}
+
+	std::optional<size_t> DelaunayMesh::get_edge_slot(const size_t triangleIndex, const size_t p0, const size_t p1) const noexcept
+	{
+		if (is_triangle_deleted(triangleIndex))
+		{
+			return {};
+		}
+		const std::array<size_t, 3> points = get_triangle_points(triangleIndex);
+		for (size_t edge = 0; edge < 3; edge++)
+		{
+			if (points[edge] == p0 && points[(edge + 1) % 3] == p1)
+			{
+				return {edge};
+			}
+		}
+		return {};
 	}
 
 	void DelaunayMesh::triangulate_points() noexcept(util::release)
 	{
+		if (m_points.size() < 4)
+		{
+			return;
+		}
+		// A triangulation of n points has about 2n triangles, counting ghosts
+		reserve_triangles(2 * m_points.size());
+		// The first triangle must not be degenerate
+		for (size_t i = 3; i < m_points.size(); i++)
+		{
+			if (orient2d(m_points[1], m_points[2], m_points[i]) != 0.0)
+			{
+				std::swap(m_points[3], m_points[i]);
+				break;
+			}
+		}
 		{
 			size_t p0 = 0, p1 = 1, p2 = 2, p3 = 3;
 			if (!is_counterclockwise(m_points[1],
@@ -121,56 +344,384 @@ namespace clm {
 			add_triangle(p0, p3, p2);
 			add_triangle(p0, p1, p3);
 		}
-		using vertices_t = std::tuple<size_t, size_t, size_t>;
-		std::stack<vertices_t> stack{};
+		// Edges v1 -> v2 of the cavity around the new point, with the triangle on their other side
+		struct CavityEdge {
+			size_t v1;
+			size_t v2;
+			std::optional<size_t> neighbor;
+		};
+		std::stack<CavityEdge> stack{};
+		m_lastTriangle = 0;
 		for (size_t i = 4; i < m_points.size(); i += 1)
 		{
 			{
-				// Prevent dangling reference below
-				const vertices_t vertices = get_enclosing_triangle(i);
-				const size_t v0 = std::get<0>(vertices);
-				const size_t v1 = std::get<1>(vertices);
-				const size_t v2 = std::get<2>(vertices);
-				delete_triangle(v0, v1, v2);
-				stack.push({i, v0, v1});
-				stack.push({i, v1, v2});
-				stack.push({i, v2, v0});
+				const size_t triangleIndex = get_enclosing_triangle(i);
+				const std::array<size_t, 3> points = get_triangle_points(triangleIndex);
+				for (size_t edge = 0; edge < 3; edge++)
+				{
+					stack.push({points[edge], points[(edge + 1) % 3], get_neighbor(triangleIndex, edge)});
+				}
+				delete_triangle_at(triangleIndex);
 			}
 			while (!stack.empty())
 			{
-				const vertices_t vertices = stack.top();
-				const size_t v0 = std::get<0>(vertices);
-				const size_t v1 = std::get<1>(vertices);
-				const size_t v2 = std::get<2>(vertices);
+				const CavityEdge cavityEdge = stack.top();
+				const size_t v0 = i;
+				const size_t v1 = cavityEdge.v1;
+				const size_t v2 = cavityEdge.v2;
 				stack.pop();
 
-				if (std::optional<size_t> v3 = get_adjacent(v2, v1))
+				if (!cavityEdge.neighbor)
+				{
+					continue;
+				}
+				// The neighbor is gone if it was removed through another edge already
+				const size_t neighbor = *cavityEdge.neighbor;
+				const std::optional<size_t> neighborEdge = get_edge_slot(neighbor, v2, v1);
+				if (!neighborEdge)
 				{
-					size_t adjacent = *v3;
-					if (encloses(m_points[i],
-								 m_points[v2],
-								 m_points[v1],
-								 m_points[adjacent]))
+					continue;
+				}
+				const size_t adjacent = get_triangle_points(neighbor)[(*neighborEdge + 2) % 3];
+				if (encloses(m_points[i],
+							 m_points[v2],
+							 m_points[v1],
+							 m_points[adjacent]))
+				{
+					stack.push({v1, adjacent, get_neighbor(neighbor, (*neighborEdge + 1) % 3)});
+					stack.push({adjacent, v2, get_neighbor(neighbor, (*neighborEdge + 2) % 3)});
+					delete_triangle_at(neighbor);
+				}
+				else
+				{
+					// Points are sorted, so the next one is close to this triangle
+					if (is_counterclockwise(m_points[v0],
+											m_points[v1],
+											m_points[v2]))
 					{
-						delete_triangle(v2, v1, adjacent);
-						stack.push({i, v1, adjacent});
-						stack.push({i, adjacent, v2});
+						m_lastTriangle = add_triangle(v0, v1, v2);
 					}
 					else
 					{
-						if (is_counterclockwise(m_points[v0], 
-												m_points[v1],
-												m_points[v2]))
-						{
-							add_triangle(v0, v1, v2);
-						}
-						else
-						{
-							add_triangle(v0, v2, v1);
-						}
+						m_lastTriangle = add_triangle(v0, v2, v1);
 					}
 				}
 			}
 		}
 	}
+
+	void DelaunayMesh::constrain_triangulation(const std::vector<std::vector<point_t>>& loops) noexcept(util::release)
+	{
+		if (get_triangle_slot_count() == 0)
+		{
+			return;
+		}
+
+		// The points were reordered for insertion, loop points are found by their position
+		std::vector<size_t> sortedIndices(m_points.size() - 1);
+		std::iota(sortedIndices.begin(), sortedIndices.end(), size_t{1});
+		std::sort(sortedIndices.begin(),
+				  sortedIndices.end(),
+				  [this](const size_t lhs, const size_t rhs)
+				  {
+					  return is_before(m_points[lhs], m_points[rhs]);
+				  });
+		const auto get_index = [this, &sortedIndices](const point_t& point) -> size_t
+		{
+			return *std::lower_bound(sortedIndices.begin(),
+									 sortedIndices.end(),
+									 point,
+									 [this](const size_t index, const point_t& p)
+									 {
+										 return is_before(m_points[index], p);
+									 });
+		};
+
+		std::vector<std::pair<size_t, size_t>> constraints{};
+		for (const std::vector<point_t>& loop : loops)
+		{
+			if (loop.size() < 2)
+			{
+				continue;
+			}
+			for (size_t i = 0; i < loop.size(); i++)
+			{
+				const size_t start = get_index(loop[i]);
+				const size_t end = get_index(loop[(i + 1) % loop.size()]);
+				if (start != end)
+				{
+					constraints.push_back({start, end});
+				}
+			}
+		}
+
+		// A triangle around every point, kept up to date as cavities are retriangulated
+		std::vector<size_t> vertexTriangles(m_points.size(), 0);
+		for (size_t i = 0; i < get_triangle_slot_count(); i++)
+		{
+			if (!is_triangle_deleted(i))
+			{
+				for (const size_t point : get_triangle_points(i))
+				{
+					vertexTriangles[point] = i;
+				}
+			}
+		}
+		for (const auto& [start, end] : constraints)
+		{
+			insert_constraint(start, end, vertexTriangles);
+		}
+
+		remove_exterior_triangles(constraints);
+	}
+
+	void DelaunayMesh::insert_constraint(const size_t start, const size_t end, std::vector<size_t>& vertexTriangles)
+	{
+		const point_t& endPoint = m_points[end];
+		size_t a = start;
+		while (a != end)
+		{
+			if (get_edge_triangle(a, end) || get_edge_triangle(end, a))
+			{
+				return;
+			}
+			const point_t& startPoint = m_points[a];
+
+			// Turn around a to the triangle (a, right, left) that the segment leaves a through, or to
+			// an edge that runs along the segment
+			const size_t firstTriangle = vertexTriangles[a];
+			size_t triangleIndex = firstTriangle;
+			std::optional<size_t> collinear{};
+			// Index of the edge right -> left in the current triangle
+			std::optional<size_t> crossedEdge{};
+			for (size_t step = 0; step < get_triangle_slot_count(); step++)
+			{
+				const std::array<size_t, 3> points = get_triangle_points(triangleIndex);
+				const size_t corner = points[0] == a ? 0 : (points[1] == a ? 1 : 2);
+				const size_t x = points[(corner + 1) % 3];
+				const size_t y = points[(corner + 2) % 3];
+				if (!is_ghost(m_points[x]))
+				{
+					const point_t& p = m_points[x];
+					const double orientation = orient2d(startPoint, p, endPoint);
+					const float dot = (p[0] - startPoint[0]) * (endPoint[0] - startPoint[0]) +
+									  (p[1] - startPoint[1]) * (endPoint[1] - startPoint[1]);
+					if (orientation == 0.0 && dot > 0.0f)
+					{
+						collinear = x;
+						break;
+					}
+					if (!is_ghost(m_points[y]) && orientation > 0.0 && orient2d(startPoint, m_points[y], endPoint) < 0.0)
+					{
+						crossedEdge = (corner + 1) % 3;
+						break;
+					}
+				}
+				// The next triangle around a is the one across y -> a
+				const std::optional<size_t> nextTriangle = get_neighbor(triangleIndex, (corner + 2) % 3);
+				if (!nextTriangle || *nextTriangle == firstTriangle)
+				{
+					break;
+				}
+				triangleIndex = *nextTriangle;
+			}
+
+			if (collinear)
+			{
+				// a to the collinear point is already an edge, continue from there
+				a = *collinear;
+				continue;
+			}
+			if (!crossedEdge)
+			{
+				// Only possible for a broken triangulation, the exterior is then found without this edge
+				return;
+			}
+
+			// Walk along the segment, removing every triangle it crosses. The vertices on either side
+			// bound the cavity, which ends at the end point or at a point on the segment.
+			const std::array<size_t, 3> firstPoints = get_triangle_points(triangleIndex);
+			size_t right = firstPoints[*crossedEdge];
+			size_t left = firstPoints[(*crossedEdge + 1) % 3];
+			std::vector<size_t> rightChain{right};
+			std::vector<size_t> leftChain{left};
+			size_t b = end;
+			while (true)
+			{
+				const std::optional<size_t> next = get_neighbor(triangleIndex, *crossedEdge);
+				delete_triangle_at(triangleIndex);
+				const std::optional<size_t> entryEdge = next ? get_edge_slot(*next, left, right) : std::nullopt;
+				if (!entryEdge)
+				{
+					return;
+				}
+				triangleIndex = *next;
+				const size_t v = get_triangle_points(triangleIndex)[(*entryEdge + 2) % 3];
+				const double orientation = v == end ? 0.0 : orient2d(startPoint, endPoint, m_points[v]);
+				if (orientation == 0.0)
+				{
+					delete_triangle_at(triangleIndex);
+					b = v;
+					break;
+				}
+				else if (orientation < 0.0)
+				{
+					// The segment goes on through v -> left
+					right = v;
+					rightChain.push_back(v);
+					crossedEdge = (*entryEdge + 2) % 3;
+				}
+				else
+				{
+					// The segment goes on through right -> v
+					left = v;
+					leftChain.push_back(v);
+					crossedEdge = (*entryEdge + 1) % 3;
+				}
+			}
+
+			triangulate_cavity(a, b, leftChain, vertexTriangles);
+			std::reverse(rightChain.begin(), rightChain.end());
+			triangulate_cavity(b, a, rightChain, vertexTriangles);
+			a = b;
+		}
+	}
+
+	void DelaunayMesh::triangulate_cavity(const size_t p0,
+										  const size_t p1,
+										  std::span<const size_t> chain,
+										  std::vector<size_t>& vertexTriangles)
+	{
+		// The chain lies left of p0 -> p1, in order from p0 to p1. The triangle over p0 -> p1 takes the
+		// chain point whose circumcircle holds no other chain point, the two parts of the chain beside
+		// it are triangulated the same way.
+		if (chain.empty())
+		{
+			return;
+		}
+		size_t apex = 0;
+		for (size_t i = 1; i < chain.size(); i++)
+		{
+			if (incircle(m_points[p0], m_points[p1], m_points[chain[apex]], m_points[chain[i]]) > 0.0)
+			{
+				apex = i;
+			}
+		}
+		triangulate_cavity(p0, chain[apex], chain.first(apex), vertexTriangles);
+		triangulate_cavity(chain[apex], p1, chain.subspan(apex + 1), vertexTriangles);
+
+		const size_t triangleIndex = add_triangle(p0, p1, chain[apex]);
+		vertexTriangles[p0] = triangleIndex;
+		vertexTriangles[p1] = triangleIndex;
+		vertexTriangles[chain[apex]] = triangleIndex;
+	}
+
+	void DelaunayMesh::remove_exterior_triangles(const std::vector<std::pair<size_t, size_t>>& constraints)
+	{
+		// Net number of times the loops run along each directed edge
+		FlatHashMap<int32_t> edgeWindings{};
+		edgeWindings.reserve(2 * constraints.size());
+		bool allEdgesPresent = true;
+		for (const auto& [start, end] : constraints)
+		{
+			edgeWindings[get_edge_key(start, end)] += 1;
+			edgeWindings[get_edge_key(end, start)] -= 1;
+			allEdgesPresent = allEdgesPresent && (get_edge_triangle(start, end) || get_edge_triangle(end, start));
+		}
+
+		constexpr int32_t unvisited = std::numeric_limits<int32_t>::min();
+		std::vector<int32_t> windings(get_triangle_slot_count(), unvisited);
+		if (allEdgesPresent)
+		{
+			// The winding number only changes across loop edges, so it's spread inwards from the ghost
+			// triangles, which are outside of every loop
+			std::stack<size_t> stack{};
+			for (size_t i = 0; i < get_triangle_slot_count(); i++)
+			{
+				if (is_triangle_deleted(i))
+				{
+					continue;
+				}
+				const std::array<size_t, 3> points = get_triangle_points(i);
+				if (util::disjunction(is_ghost(m_points[points[0]]),
+									  is_ghost(m_points[points[1]]),
+									  is_ghost(m_points[points[2]])))
+				{
+					windings[i] = 0;
+					stack.push(i);
+				}
+			}
+			while (!stack.empty())
+			{
+				const size_t triangleIndex = stack.top();
+				stack.pop();
+				const std::array<size_t, 3> points = get_triangle_points(triangleIndex);
+				for (size_t i = 0; i < 3; i++)
+				{
+					const size_t start = points[i];
+					const size_t end = points[(i + 1) % 3];
+					const std::optional<size_t> neighbor = get_neighbor(triangleIndex, i);
+					if (!neighbor || windings[*neighbor] != unvisited)
+					{
+						continue;
+					}
+					// Triangles are counterclockwise, so the neighbor is right of start -> end
+					const int32_t* edgeWinding = edgeWindings.find(get_edge_key(start, end));
+					windings[*neighbor] = windings[triangleIndex] - (edgeWinding ? *edgeWinding : 0);
+					stack.push(*neighbor);
+				}
+			}
+		}
+		else
+		{
+			// Loops that cross each other lose edges, the winding number is then computed directly
+			for (size_t i = 0; i < get_triangle_slot_count(); i++)
+			{
+				if (is_triangle_deleted(i))
+				{
+					continue;
+				}
+				const std::array<size_t, 3> points = get_triangle_points(i);
+				if (util::disjunction(is_ghost(m_points[points[0]]),
+									  is_ghost(m_points[points[1]]),
+									  is_ghost(m_points[points[2]])))
+				{
+					continue;
+				}
+				const point_t centroid{(m_points[points[0]][0] + m_points[points[1]][0] + m_points[points[2]][0]) / 3.0f,
+									   (m_points[points[0]][1] + m_points[points[1]][1] + m_points[points[2]][1]) / 3.0f};
+				windings[i] = get_winding_number(centroid, constraints);
+			}
+		}
+
+		for (size_t i = 0; i < get_triangle_slot_count(); i++)
+		{
+			if (!is_triangle_deleted(i) && (windings[i] == 0 || windings[i] == unvisited))
+			{
+				delete_triangle_at(i);
+			}
+		}
+	}
+
+	int32_t DelaunayMesh::get_winding_number(const point_t& point, const std::vector<std::pair<size_t, size_t>>& constraints) const noexcept
+	{
+		int32_t winding = 0;
+		for (const auto& [start, end] : constraints)
+		{
+			const point_t& p0 = m_points[start];
+			const point_t& p1 = m_points[end];
+			if (p0[1] <= point[1])
+			{
+				if (p1[1] > point[1] && orient2d(p0, p1, point) > 0.0)
+				{
+					winding++;
+				}
+			}
+			else if (p1[1] <= point[1] && orient2d(p0, p1, point) < 0.0)
+			{
+				winding--;
+			}
+		}
+		return winding;
+	}
 }
\ No newline at end of file
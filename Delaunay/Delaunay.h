@@ -7,6 +7,7 @@
 #include <stdexcept>
 #include <unordered_set>
 #include <optional>
+#include <span>
 
 #include <clmMath/clm_vector.h>
 #include <clmUtil/clm_util.h>
@@ -16,21 +17,48 @@
 #include <DelaunayUtil.h>
 
 namespace clm {
+	// Order in which points are inserted. Sorted inserts them lexicographically by (x, y), Brio
+	// (biased randomized insertion order) splits them into rounds of doubling size and inserts each
+	// round along a Hilbert curve. The random rounds keep intermediate triangulations well shaped
+	// and the curve keeps consecutive points close together for the point location walk. The
+	// rounds come from a fixed seed, so the result doesn't change between runs.
+	enum class InsertionOrder {
+		Sorted, Brio
+	};
+
 	class DelaunayMesh : public Mesh
 	{
 	public:
 		DelaunayMesh() noexcept = default;
-		DelaunayMesh(const std::vector<point_t>& points);
+		DelaunayMesh(const std::vector<point_t>& points, const InsertionOrder = InsertionOrder::Sorted);
+		// Constrained triangulation of closed loops: every loop edge is an edge of the mesh and only
+		// the triangles with a nonzero winding number (the inside of the outline) are kept. Neither
+		// constructor leaves ghost triangles (the ones with the point at infinity) in the mesh.
+		DelaunayMesh(const std::vector<std::vector<point_t>>& loops, const InsertionOrder = InsertionOrder::Sorted);
 		DelaunayMesh(const DelaunayMesh&) = default;
 		DelaunayMesh(DelaunayMesh&& mesh) noexcept = default;
 		~DelaunayMesh() = default;
 		DelaunayMesh& operator=(const DelaunayMesh&) = default;
 		DelaunayMesh& operator=(DelaunayMesh&&) noexcept = default;
 	private:
-		std::tuple<size_t, size_t, size_t> get_enclosing_triangle(size_t) const noexcept(util::release);
-		std::optional<size_t> get_adjacent(size_t, size_t) const noexcept(util::release);
+		void insert_points(const std::vector<point_t>&, const InsertionOrder);
+		void finish_triangulation();
+		void sort_points() noexcept;
+		void brio_order_points();
+		size_t get_enclosing_triangle(size_t) const noexcept(util::release);
+		std::optional<size_t> walk_to_triangle(size_t) const noexcept(util::release);
+		// Index of the edge p0 -> p1 in the triangle, if the triangle still has it
+		std::optional<size_t> get_edge_slot(size_t, size_t, size_t) const noexcept;
 		void triangulate_points() noexcept(util::release);
 		void constrain_triangulation(const std::vector<std::vector<point_t>>& loops) noexcept (util::release);
+		static std::vector<point_t> get_unique_points(const std::vector<std::vector<point_t>>&);
+		void insert_constraint(size_t, size_t, std::vector<size_t>&);
+		void triangulate_cavity(size_t, size_t, std::span<const size_t>, std::vector<size_t>&);
+		void remove_exterior_triangles(const std::vector<std::pair<size_t, size_t>>&);
+		int32_t get_winding_number(const point_t&, const std::vector<std::pair<size_t, size_t>>&) const noexcept;
+
+		// Where the next point location walk starts
+		size_t m_lastTriangle = 0;
 
 		//std::unordered_set<std::shared_ptr<Triangle>> m_invalidTriangles;
 		//std::unordered_set<std::shared_ptr<Triangle>> m_visitedTriangles;
@@ -1,33 +1,40 @@
 #include <DelaunayUtil.h>
 
+#include <algorithm>
+
 namespace clm {
+	namespace {
+		// The circumcircle of a ghost triangle is the open half plane left of its real edge plus the
+		// edge itself, not the rest of the line through it
+		bool ghost_encloses(const point_t& newPoint, const point_t& p0, const point_t& p1) noexcept
+		{
+			const double orientation = orient2d(p0, p1, newPoint);
+			if (orientation != 0.0)
+			{
+				return orientation > 0.0;
+			}
+			return std::min(p0[0], p1[0]) <= newPoint[0] && newPoint[0] <= std::max(p0[0], p1[0]) &&
+				   std::min(p0[1], p1[1]) <= newPoint[1] && newPoint[1] <= std::max(p0[1], p1[1]);
+		}
+	}
+
 	bool encloses(const point_t& newPoint, const point_t& p0, const point_t& p1, const point_t& p2) noexcept
 	{
 		if (is_ghost(p0))
 		{
-			return is_counterclockwise(p1, p2, newPoint);
+			return ghost_encloses(newPoint, p1, p2);
 		}
 		else if (is_ghost(p1))
 		{
-			return is_counterclockwise(p2, p0, newPoint);
+			return ghost_encloses(newPoint, p2, p0);
 		}
 		else if (is_ghost(p2))
 		{
-			return is_counterclockwise(p0, p1, newPoint);
+			return ghost_encloses(newPoint, p0, p1);
 		}
 		else
 		{
-			const float p0xDiff = p0[0] - newPoint[0];
-			const float p0yDiff = p0[1] - newPoint[1];
-			const float p1xDiff = p1[0] - newPoint[0];
-			const float p1yDiff = p1[1] - newPoint[1];
-			const float p2xDiff = p2[0] - newPoint[0];
-			const float p2yDiff = p2[1] - newPoint[1];
-			math::Matrix<3> matrix{{ p0xDiff, p0yDiff, p0xDiff * p0xDiff + p0yDiff * p0yDiff },
-									{ p1xDiff, p1yDiff, p1xDiff * p1xDiff + p1yDiff * p1yDiff },
-									{ p2xDiff, p2yDiff, p2xDiff * p2xDiff + p2yDiff * p2yDiff }};
-			const float determinant = matrix.determinant();
-			return determinant > 0.0f;
+			return incircle(p0, p1, p2, newPoint) > 0.0;
 		}
 	}
 
@@ -0,0 +1,131 @@
+#include "Endian.h"
+
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CLM_BYTESWAP_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CLM_BYTESWAP_SSE2 1
+#endif
+
+namespace clm {
+	namespace {
+		template<typename T>
+		void byteswap_copy_scalar(const byte* src, T* dest, size_t count) noexcept
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				T val{};
+				std::memcpy(&val, src + i * sizeof(T), sizeof(T));
+				dest[i] = std::byteswap(val);
+			}
+		}
+	}
+
+	void byteswap_copy(const byte* src, uint16_t* dest, size_t count) noexcept
+	{
+		size_t i = 0;
+#if CLM_BYTESWAP_AVX2
+		const __m256i shuffle16 = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+												   1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+		for (; i + 16 <= count; i += 16)
+		{
+			const __m256i val = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * sizeof(uint16_t)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), _mm256_shuffle_epi8(val, shuffle16));
+		}
+#endif
+#if CLM_BYTESWAP_SSE2
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m128i val = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * sizeof(uint16_t)));
+			const __m128i swapped = _mm_or_si128(_mm_slli_epi16(val, 8), _mm_srli_epi16(val, 8));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), swapped);
+		}
+#endif
+		byteswap_copy_scalar(src + i * sizeof(uint16_t), dest + i, count - i);
+	}
+
+	void byteswap_copy(const byte* src, uint32_t* dest, size_t count) noexcept
+	{
+		size_t i = 0;
+#if CLM_BYTESWAP_AVX2
+		const __m256i shuffle32 = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+												   3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256i val = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * sizeof(uint32_t)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), _mm256_shuffle_epi8(val, shuffle32));
+		}
+#endif
+#if CLM_BYTESWAP_SSE2
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i val = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * sizeof(uint32_t)));
+			// Swap the bytes within each 16 bit half, then swap the halves
+			const __m128i bytesSwapped = _mm_or_si128(_mm_slli_epi16(val, 8), _mm_srli_epi16(val, 8));
+			const __m128i swapped = _mm_shufflehi_epi16(_mm_shufflelo_epi16(bytesSwapped, 0xB1), 0xB1);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), swapped);
+		}
+#endif
+		byteswap_copy_scalar(src + i * sizeof(uint32_t), dest + i, count - i);
+	}
+
+	uint32_t checksum_be32(const byte* data, size_t length) noexcept
+	{
+		const size_t count = length / sizeof(uint32_t);
+		size_t i = 0;
+		// Lanes wrap around just like the final sum does, so they can be summed independently
+		uint32_t sum = 0;
+#if CLM_BYTESWAP_AVX2
+		{
+			const __m256i shuffle32 = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+													   3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+			__m256i lanes = _mm256_setzero_si256();
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m256i val = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i * sizeof(uint32_t)));
+				lanes = _mm256_add_epi32(lanes, _mm256_shuffle_epi8(val, shuffle32));
+			}
+			alignas(32) uint32_t laneSums[8]{};
+			_mm256_store_si256(reinterpret_cast<__m256i*>(laneSums), lanes);
+			for (const uint32_t laneSum : laneSums)
+			{
+				sum += laneSum;
+			}
+		}
+#endif
+#if CLM_BYTESWAP_SSE2
+		{
+			__m128i lanes = _mm_setzero_si128();
+			for (; i + 4 <= count; i += 4)
+			{
+				const __m128i val = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * sizeof(uint32_t)));
+				const __m128i bytesSwapped = _mm_or_si128(_mm_slli_epi16(val, 8), _mm_srli_epi16(val, 8));
+				lanes = _mm_add_epi32(lanes, _mm_shufflehi_epi16(_mm_shufflelo_epi16(bytesSwapped, 0xB1), 0xB1));
+			}
+			alignas(16) uint32_t laneSums[4]{};
+			_mm_store_si128(reinterpret_cast<__m128i*>(laneSums), lanes);
+			for (const uint32_t laneSum : laneSums)
+			{
+				sum += laneSum;
+			}
+		}
+#endif
+		for (; i < count; i++)
+		{
+			uint32_t val{};
+			std::memcpy(&val, data + i * sizeof(uint32_t), sizeof(uint32_t));
+			sum += std::byteswap(val);
+		}
+
+		// Trailing bytes fill the high end of a zero padded word
+		for (size_t j = count * sizeof(uint32_t); j < length; j++)
+		{
+			sum += static_cast<uint32_t>(std::to_integer<uint8_t>(data[j])) << (8 * (3 - j % sizeof(uint32_t)));
+		}
+		return sum;
+	}
+}
\ No newline at end of file
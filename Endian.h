@@ -0,0 +1,31 @@
+#ifndef ENDIAN_H
+#define ENDIAN_H
+#include <cstddef>
+#include <cstdint>
+#include <concepts>
+#include <bit>
+
+using std::byte;
+
+namespace clm {
+	enum class Endian {
+		Big, Little
+	};
+
+	template<std::integral T>
+	constexpr void change_endian(T& t)
+	{
+		t = std::byteswap(t);
+	}
+
+	// Copies count elements from src (no alignment requirement) to dest, reversing the byte order
+	// of each element. Vectorized with AVX2/SSE2 when the target supports it.
+	void byteswap_copy(const byte* src, uint16_t* dest, size_t count) noexcept;
+	void byteswap_copy(const byte* src, uint32_t* dest, size_t count) noexcept;
+
+	// Sum (mod 2^32) of length bytes read as big-endian uint32 words, a partial last word is
+	// zero padded. This is the OpenType table checksum. Vectorized like byteswap_copy.
+	uint32_t checksum_be32(const byte* data, size_t length) noexcept;
+}
+
+#endif
\ No newline at end of file
@@ -1,12 +1,22 @@
 #include "File.h"
 
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace clm {
-	File::File(const std::string& fileName, Endian fileEndian, Endian requestEndian)
+#ifdef _WIN32
+	File::File(const std::string& fileName, Endian fileEndian, Endian requestEndian, FileMode fileMode)
 		:
 		File()
 	{
 		m_fileEndian = fileEndian;
 		m_requestEndian = requestEndian;
+		m_fileMode = fileMode;
 		m_fileName = fileName;
 
 		HANDLE fileHandle = CreateFileA(fileName.c_str(),
@@ -29,53 +39,164 @@ namespace clm {
 			throw GetLastError();
 		}
 		std::uint64_t fileSize = static_cast<std::uint64_t>(fileSizeTmp.QuadPart);
-		m_fileBuffer.resize(fileSize);
-		DWORD bytesRead{};
-
-		if (ReadFile(fileHandle,
-					 m_fileBuffer.data(),
-					 static_cast<DWORD>(fileSize),
-					 &bytesRead,
-					 NULL) == 0 || static_cast<uint64_t>(bytesRead) != fileSize)
+		if (fileSize == 0)
 		{
 			CloseHandle(fileHandle);
-			throw GetLastError();
+			return;
+		}
+
+		if (m_fileMode == FileMode::Mapped)
+		{
+			HANDLE mappingHandle = CreateFileMappingA(fileHandle,
+													  NULL,
+													  PAGE_READONLY,
+													  0,
+													  0,
+													  NULL);
+			if (mappingHandle == NULL)
+			{
+				DWORD error = GetLastError();
+				CloseHandle(fileHandle);
+				throw error;
+			}
+
+			const void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+			DWORD error = GetLastError();
+			// The view keeps the mapping alive, the handles aren't needed past this point
+			CloseHandle(mappingHandle);
+			CloseHandle(fileHandle);
+			if (view == NULL)
+			{
+				throw error;
+			}
+
+			m_storage = std::shared_ptr<const byte[]>(static_cast<const byte*>(view),
+													  [](const byte* p)
+													  {
+														  UnmapViewOfFile(p);
+													  });
+		}
+		else
+		{
+			std::shared_ptr<byte[]> buffer = std::make_shared_for_overwrite<byte[]>(fileSize);
+			DWORD bytesRead{};
+
+			if (ReadFile(fileHandle,
+						 buffer.get(),
+						 static_cast<DWORD>(fileSize),
+						 &bytesRead,
+						 NULL) == 0 || static_cast<uint64_t>(bytesRead) != fileSize)
+			{
+				CloseHandle(fileHandle);
+				throw GetLastError();
+			}
+
+			CloseHandle(fileHandle);
+			m_storage = std::move(buffer);
+		}
+		m_fileBuffer = std::span<const byte>{m_storage.get(), static_cast<size_t>(fileSize)};
+	}
+#else
+	File::File(const std::string& fileName, Endian fileEndian, Endian requestEndian, FileMode fileMode)
+		:
+		File()
+	{
+		m_fileEndian = fileEndian;
+		m_requestEndian = requestEndian;
+		m_fileMode = fileMode;
+		m_fileName = fileName;
+
+		// Errors are reported the same way as the Win32 path, by throwing the system error code
+		using error_t = unsigned long;
+
+		const int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd == -1)
+		{
+			throw static_cast<error_t>(errno);
+		}
+
+		struct stat fileStat{};
+		if (fstat(fd, &fileStat) == -1)
+		{
+			const error_t error = static_cast<error_t>(errno);
+			close(fd);
+			throw error;
 		}
+		const size_t fileSize = static_cast<size_t>(fileStat.st_size);
+		if (fileSize == 0)
+		{
+			close(fd);
+			return;
+		}
+
+		if (m_fileMode == FileMode::Mapped)
+		{
+			void* view = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+			const error_t error = static_cast<error_t>(errno);
+			// The mapping holds its own reference to the file
+			close(fd);
+			if (view == MAP_FAILED)
+			{
+				throw error;
+			}
 
-		CloseHandle(fileHandle);
+			m_storage = std::shared_ptr<const byte[]>(static_cast<const byte*>(view),
+													  [fileSize](const byte* p)
+													  {
+														  munmap(const_cast<byte*>(p), fileSize);
+													  });
+		}
+		else
+		{
+			std::shared_ptr<byte[]> buffer = std::make_shared_for_overwrite<byte[]>(fileSize);
+			size_t totalRead = 0;
+			while (totalRead < fileSize)
+			{
+				const ssize_t bytesRead = read(fd, buffer.get() + totalRead, fileSize - totalRead);
+				if (bytesRead == -1 && errno == EINTR)
+				{
+					continue;
+				}
+				if (bytesRead <= 0)
+				{
+					const error_t error = static_cast<error_t>(bytesRead == 0 ? EIO : errno);
+					close(fd);
+					throw error;
+				}
+				totalRead += static_cast<size_t>(bytesRead);
+			}
+
+			close(fd);
+			m_storage = std::move(buffer);
+		}
+		m_fileBuffer = std::span<const byte>{m_storage.get(), fileSize};
 	}
+#endif
 
-	File File::open_file(const std::string& fileName, const Endian fileEndian, const Endian requestEndian)
+	File File::open_file(const std::string& fileName, const Endian fileEndian, const Endian requestEndian, const FileMode fileMode)
 	{
-		File file{ fileName, fileEndian, requestEndian };
+		File file{ fileName, fileEndian, requestEndian, fileMode };
 		return file;
 	}
 
 	size_t File::size() const noexcept { return m_fileBuffer.size(); }
 
-	void File::set_position(size_t fileOffset) const noexcept(util::release)
+	std::span<const byte> File::data() const noexcept { return m_fileBuffer; }
+
+	FileMode File::mode() const noexcept { return m_fileMode; }
+
+	ByteReader File::reader() const noexcept
 	{
-#ifdef _DEBUG
-		if (fileOffset >= m_fileBuffer.size())
-		{
-			throw std::out_of_range{ "Attempting to set fileOffset beyond fileBuffer bounds" };
-		}
-		m_offset = fileOffset;
-#else
-		m_offset = fileOffset >= m_fileBuffer.size() ? 0 : fileOffset;
-#endif
+		return ByteReader{m_fileBuffer, m_fileEndian, m_requestEndian};
 	}
 
-	size_t File::get_position() const noexcept { return m_offset; }
-
-	const File& operator>>(const File& file, std::string& dest)
+	ByteReader File::reader(size_t offset) const noexcept(util::release)
 	{
-		file.get_data(dest.data(), dest.size());
-		return file;
+		return reader().subreader(offset);
 	}
 
-	const File& operator<<(std::string& dest, const File& file)
+	ByteReader File::reader(size_t offset, size_t length) const noexcept(util::release)
 	{
-		return file >> dest;
+		return reader().subreader(offset, length);
 	}
 }
\ No newline at end of file
@@ -1,27 +1,33 @@
 #include "Font.h"
 
 #include <iostream>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <span>
 
 #include <clmUtil/clm_err.h>
 #include <clmUtil/clm_concepts_ext.h>
 #include <clmMath/clm_geo.h>
 
 #include <Mesh.h>
+#include <EarClip.h>
 
 namespace clm {
-	Font::Font(std::string fontName, const float pointSize)
+	Font::Font(std::string fontName, const float pointSize, const GlyphLoading glyphLoading, std::string meshCacheFile, const ValidationLevel validationLevel)
 		:
 		Font()
 	{
-		// fontName should be the name of the requested font sans .ttf
+		// fontName should be the name of the requested font sans .ttf, or the path of a .ttf file
 		m_fontName = fontName;
 		m_pointSize = pointSize;
-		m_fileName = std::format("C:/Windows/Fonts/{}.ttf", fontName);
+		m_fileName = fontName.ends_with(".ttf") ? fontName : std::format("C:/Windows/Fonts/{}.ttf", fontName);
 
 		File fontFile{};
 		try
 		{
-			fontFile = std::move(File::open_file(m_fileName, Endian::Big));
+			fontFile = std::move(File::open_file(m_fileName, Endian::Big, Endian::Little, FileMode::Mapped));
 			if (fontFile.size() < (sizeof(OffsetTable) + 8 * sizeof(TableRecord)))
 			{
 				throw std::runtime_error{ std::format("Font file for {} is malformed.\nFile: {}\n", m_fontName, m_fileName) };
@@ -32,41 +38,69 @@ namespace clm {
 			throw std::runtime_error{ std::format("Error opening font: {}\nFile name: {}\nError: {}\n", m_fontName, m_fileName, d) };
 		}
 
-		create_offset_table(fontFile);
-		create_table_records(fontFile);
-		validate_font(fontFile);
+		ByteReader directoryReader = fontFile.reader();
+		create_offset_table(directoryReader);
+		create_table_records(directoryReader);
+		validate_font(fontFile, validationLevel);
 		create_maximum_profile_table(fontFile);
 		create_font_header_table(fontFile);
-		create_glyph_mapping(fontFile);
-		triangulate_characters();
+		create_horizontal_header_table(fontFile);
+		m_horizontalMetrics = HorizontalMetrics{get_table_reader(fontFile, "hmtx"),
+												m_horizontalHeaderTable.numberOfHMetrics,
+												m_maximumProfileTable.numGlyphs};
+		m_kerningTable = create_kerning_table(fontFile);
+		m_indexLocationTable = create_index_location_table(fontFile);
+		m_glyphOutlines = GlyphOutlineStore{m_maximumProfileTable.numGlyphs};
+		m_characterMap = create_character_map(fontFile, create_cgmit(fontFile));
+		m_glyfReader = get_table_reader(fontFile, "glyf");
+		// Keep the (shared, mapped) file alive for the glyphs decoded later on
+		m_fontFile = std::move(fontFile);
+		if (!meshCacheFile.empty())
+		{
+			m_meshCache = MeshCache{std::move(meshCacheFile), get_font_key(), get_tessellation_key()};
+		}
+
+		if (glyphLoading == GlyphLoading::Eager)
+		{
+			build_cmap_lookup_table();
+			load_glyphs();
+		}
 	}
 
-	CurveSet Font::get_glyph(const wchar_t character) noexcept
+	uint64_t Font::get_font_key() const noexcept
 	{
-		auto glyphMapIter = m_charGlyphMap.find(character);
-		const GlyphDesc::SimpleGlyphDesc& glyphDesc = (glyphMapIter != m_charGlyphMap.end() ? glyphMapIter->second.desc : m_missingGlyph.desc);
+		// checksumAdjustment covers the whole file, the table checksums guard against the rare collision
+		uint32_t tableChecksums = 0;
+		for (const TableRecord& tr : m_tableRecords)
+		{
+			tableChecksums += tr.checksum;
+		}
+		return (static_cast<uint64_t>(m_fontHeaderTable.checksumAdjustment) << 32) | static_cast<uint64_t>(tableChecksums);
+	}
 
-		return get_curve_set(glyphDesc);
+	uint64_t Font::get_tessellation_key() const noexcept
+	{
+		// Identifies everything that changes the meshes generated from the same font,
+		// bump the version whenever triangulation output changes. The level of detail is
+		// part of each cached mesh's key instead.
+		constexpr uint64_t tessellationVersion = 8;
+		return tessellationVersion;
 	}
 
-	CurveSet Font::get_curve_set(const GlyphDesc::SimpleGlyphDesc& glyphDesc) const noexcept
+	Font::lod_bucket_t Font::get_lod_bucket(const float pointSize) const noexcept
 	{
-		CurveSet glyph{};
-		uint16_t startIndex = 0;
-		float unitsPerEm = static_cast<float>(m_fontHeaderTable.unitsPerEm);
-		for (size_t i = 0; i < glyphDesc.endPtsOfContours.size(); i++)
-		{
-			uint16_t lastIndex = glyphDesc.endPtsOfContours[i];
-			glyph.emplace_back();
-			for (uint16_t j = startIndex; j <= lastIndex; j++)
-			{
-				glyph.rbegin()->emplace_back(glyphDesc.points[j].flag & ON_CURVE_POINT,
-											 GFXPointType{static_cast<float>(glyphDesc.points[j].data[0]) / unitsPerEm,
-											 -1.0f * static_cast<float>(glyphDesc.points[j].data[1]) / unitsPerEm});
-			}
-			startIndex = lastIndex + 1;
-		}
-		return glyph;
+		// Bucket b holds meshes for up to 2^b pixels per em (at 96 DPI)
+		constexpr float pixelsPerPoint = 96.0f / 72.0f;
+		constexpr lod_bucket_t minBucket = 3;
+		// Sizes under a pixel (and NaN) use the coarsest bucket, bit_width(0 - 1) would pick the finest
+		const float pixelsPerEm = std::min(std::max(1.0f, pointSize * pixelsPerPoint), 65536.0f);
+		const auto bucket = static_cast<lod_bucket_t>(std::bit_width(static_cast<uint32_t>(std::ceil(pixelsPerEm)) - 1));
+		return std::clamp(bucket, minBucket, static_cast<lod_bucket_t>(s_lodBucketCount - 1));
+	}
+
+	GlyphOutlineView Font::get_glyph(const char32_t character)
+	{
+		return get_glyph_outline(get_glyph_index(character));
 	}
 
 	Font::TRIter Font::read_from_record_table(std::string tableName)
@@ -85,14 +119,30 @@ namespace clm {
 		return table;
 	}
 
-	void Font::create_offset_table(const File& fontFile)
+	ByteReader Font::get_table_reader(const File& fontFile, std::string tableName)
+	{
+		const TRIter table = read_from_record_table(tableName);
+		return fontFile.reader(table->offset, table->length);
+	}
+
+	bool Font::has_table(const std::string& tableName) const noexcept
+	{
+		return std::any_of(m_tableRecords.begin(),
+						   m_tableRecords.end(),
+						   [&tableName](const TableRecord& tr)
+						   {
+							   return util::compare(tr.tableTag, tableName);
+						   });
+	}
+
+	void Font::create_offset_table(ByteReader& directoryReader)
 	{
 		// Get header
-		fontFile >> m_offsetTable.scalarType;
-		fontFile >> m_offsetTable.numTables;
-		fontFile >> m_offsetTable.searchRange;
-		fontFile >> m_offsetTable.entrySelector;
-		fontFile >> m_offsetTable.rangeShift;
+		directoryReader >> m_offsetTable.scalarType;
+		directoryReader >> m_offsetTable.numTables;
+		directoryReader >> m_offsetTable.searchRange;
+		directoryReader >> m_offsetTable.entrySelector;
+		directoryReader >> m_offsetTable.rangeShift;
 
 		verify_offset_table_vals();
 	}
@@ -111,16 +161,16 @@ namespace clm {
 		}
 	}
 
-	void Font::create_table_records(const File& fontFile) noexcept(util::release)
+	void Font::create_table_records(ByteReader& directoryReader) noexcept(util::release)
 	{
 		m_tableRecords.resize(m_offsetTable.numTables);
 		for (size_t i = 0; i < m_tableRecords.size(); i++)
 		{
 			m_tableRecords[i].tableTag.resize(4);
-			fontFile >> m_tableRecords[i].tableTag;
-			fontFile >> m_tableRecords[i].checksum;
-			fontFile >> m_tableRecords[i].offset;
-			fontFile >> m_tableRecords[i].length;
+			directoryReader >> m_tableRecords[i].tableTag;
+			directoryReader >> m_tableRecords[i].checksum;
+			directoryReader >> m_tableRecords[i].offset;
+			directoryReader >> m_tableRecords[i].length;
 		}
 		std::sort(m_tableRecords.begin(),
 				  m_tableRecords.end(),
@@ -130,24 +180,12 @@ namespace clm {
 				  });
 	}
 
-	uint32_t Font::calc_checksum(const File& fontFile, uint32_t offset, size_t length) const noexcept
+	uint32_t Font::calc_checksum(const File& fontFile, size_t offset, size_t length) const noexcept(util::release)
 	{
-		const size_t count = (length + 3) / sizeof(uint32_t);
-		uint32_t val = 0;
-		uint64_t sum = 0;
-		[[unlikely]] if (offset == 0)
-		{
-			fontFile.set_position(0);
-		}
-
-		for (size_t i = 0; i < count; i++)
-		{
-			fontFile.get_data_raw(val, offset);
-			change_endian(val);
-			sum += static_cast<uint64_t>(val);
-			offset += sizeof(uint32_t);
-		}
-		return static_cast<uint32_t>(sum);
+		// Checksums are always summed as big-endian words, regardless of the requested endian
+		const std::span<const byte> data = fontFile.data();
+		err::assert<std::out_of_range>(offset <= data.size() && length <= data.size() - offset, "Checksum range goes beyond the file");
+		return checksum_be32(data.data() + offset, length);
 	}
 
 	uint32_t Font::get_checksum_adjustment(const File& fontFile, size_t headTableOffset) const
@@ -157,39 +195,22 @@ namespace clm {
 		return checksumAdjustment;
 	}
 
-	void Font::validate_font(const File& fontFile)
+	void Font::validate_font(const File& fontFile, const ValidationLevel validationLevel)
 	{
-		// Check checksums
-		uint32_t checksumAdjustment = 0;
+		if (validationLevel == ValidationLevel::None)
+		{
+			return;
+		}
+
+		// Make sure every table lies within the file
 		for (const auto& tr : m_tableRecords)
 		{
-			[[unlikely]] if (util::compare(tr.tableTag, "head"))
-			{
-				checksumAdjustment = get_checksum_adjustment(fontFile, tr.offset);
-				uint32_t checksum = calc_checksum(fontFile, tr.offset, tr.length);
-				checksum -= checksumAdjustment;
-				if (tr.checksum != checksum)
-				{
-					throw std::runtime_error{ std::format("Font file error for {}: mismatched checksum error.\n\
-										Table: {}\nFile: {}", m_fontName, tr.tableTag, m_fileName) };
-				}
-			}
-			else
+			if (tr.offset > fontFile.size() || tr.length > fontFile.size() - tr.offset)
 			{
-				if (tr.checksum != calc_checksum(fontFile, tr.offset, tr.length))
-				{
-					throw std::runtime_error{ std::format("Font file error for {}: mismatched checksum error.\n\
+				throw std::runtime_error{ std::format("Font file error for {}: table extends beyond the end of the file.\n\
 										Table: {}\nFile: {}", m_fontName, tr.tableTag, m_fileName) };
-				}
 			}
 		}
-		uint32_t fontChecksum = calc_checksum(fontFile, 0, fontFile.size());
-		fontChecksum -= checksumAdjustment;
-		if (checksumAdjustment != (0xB1B0AFBA - fontChecksum))
-		{
-			throw std::runtime_error{ std::format("Font file error for {}: mismatched font file checksum error.\n\
-										File: {}", m_fontName, m_fileName) };
-		}
 
 		// Make sure the required tables are present
 		using namespace std::string_literals;
@@ -207,506 +228,976 @@ namespace clm {
 				throw std::runtime_error{ std::format("Missing {} table in font {}\nFile: {}\n", t, m_fontName, m_fileName) };
 			}
 		}
+
+		if (validationLevel == ValidationLevel::HeaderOnly)
+		{
+			return;
+		}
+
+		// Check checksums. Tables normally start on 4 byte boundaries and don't overlap, in which case the
+		// file checksum is the sum of the table checksums and of the words between the tables, so every
+		// byte is only read once. Otherwise the whole file is summed separately.
+		const std::span<const byte> data = fontFile.data();
+		uint32_t checksumAdjustment = 0;
+		uint32_t fontChecksum = 0;
+		bool singlePass = true;
+		size_t position = 0;
+		for (const auto& tr : m_tableRecords)
+		{
+			const uint32_t tableSum = calc_checksum(fontFile, tr.offset, tr.length);
+			uint32_t checksum = tableSum;
+			[[unlikely]] if (util::compare(tr.tableTag, "head"))
+			{
+				checksumAdjustment = get_checksum_adjustment(fontFile, tr.offset);
+				checksum -= checksumAdjustment;
+			}
+			if (tr.checksum != checksum)
+			{
+				throw std::runtime_error{ std::format("Font file error for {}: mismatched checksum error.\n\
+										Table: {}\nFile: {}", m_fontName, tr.tableTag, m_fileName) };
+			}
+
+			if (singlePass && tr.offset % sizeof(uint32_t) == 0 && tr.offset >= position)
+			{
+				fontChecksum += calc_checksum(fontFile, position, tr.offset - position);
+				fontChecksum += tableSum;
+				// The padding after a table shares the table's last word
+				const size_t tableEnd = static_cast<size_t>(tr.offset) + tr.length;
+				const size_t paddedEnd = std::min((tableEnd + 3) & ~size_t{3}, data.size());
+				for (size_t j = tableEnd; j < paddedEnd; j++)
+				{
+					fontChecksum += static_cast<uint32_t>(std::to_integer<uint8_t>(data[j])) << (8 * (3 - j % sizeof(uint32_t)));
+				}
+				position = paddedEnd;
+			}
+			else
+			{
+				singlePass = false;
+			}
+		}
+		if (singlePass)
+		{
+			fontChecksum += calc_checksum(fontFile, position, data.size() - position);
+		}
+		else
+		{
+			fontChecksum = calc_checksum(fontFile, 0, data.size());
+		}
+		fontChecksum -= checksumAdjustment;
+		if (checksumAdjustment != (0xB1B0AFBA - fontChecksum))
+		{
+			throw std::runtime_error{ std::format("Font file error for {}: mismatched font file checksum error.\n\
+										File: {}", m_fontName, m_fileName) };
+		}
 	}
 
 	void Font::create_maximum_profile_table(const File& fontFile) noexcept(util::release)
 	{
-		uint32_t offset = read_from_record_table("maxp")->offset;
-		fontFile.set_position(offset);
-		fontFile >> m_maximumProfileTable.version;
-		fontFile >> m_maximumProfileTable.numGlyphs;
-		fontFile >> m_maximumProfileTable.maxPoints;
-		fontFile >> m_maximumProfileTable.maxContours;
-		fontFile >> m_maximumProfileTable.maxCompositePoints;
-		fontFile >> m_maximumProfileTable.maxCompositeContours;
-		fontFile >> m_maximumProfileTable.maxZones;
-		fontFile >> m_maximumProfileTable.maxTwilightPoints;
-		fontFile >> m_maximumProfileTable.maxStorage;
-		fontFile >> m_maximumProfileTable.maxFunctionDefs;
-		fontFile >> m_maximumProfileTable.maxInstructionDefs;
-		fontFile >> m_maximumProfileTable.maxStackElements;
-		fontFile >> m_maximumProfileTable.maxSizeOfInstructions;
-		fontFile >> m_maximumProfileTable.maxComponentElements;
-		fontFile >> m_maximumProfileTable.maxComponentDepth;
+		ByteReader tableReader = get_table_reader(fontFile, "maxp");
+		tableReader >> m_maximumProfileTable.version;
+		tableReader >> m_maximumProfileTable.numGlyphs;
+		tableReader >> m_maximumProfileTable.maxPoints;
+		tableReader >> m_maximumProfileTable.maxContours;
+		tableReader >> m_maximumProfileTable.maxCompositePoints;
+		tableReader >> m_maximumProfileTable.maxCompositeContours;
+		tableReader >> m_maximumProfileTable.maxZones;
+		tableReader >> m_maximumProfileTable.maxTwilightPoints;
+		tableReader >> m_maximumProfileTable.maxStorage;
+		tableReader >> m_maximumProfileTable.maxFunctionDefs;
+		tableReader >> m_maximumProfileTable.maxInstructionDefs;
+		tableReader >> m_maximumProfileTable.maxStackElements;
+		tableReader >> m_maximumProfileTable.maxSizeOfInstructions;
+		tableReader >> m_maximumProfileTable.maxComponentElements;
+		tableReader >> m_maximumProfileTable.maxComponentDepth;
 	}
 
 	void Font::create_font_header_table(const File& fontFile) noexcept(util::release)
 	{
-		uint32_t offset = read_from_record_table("head")->offset;
-		fontFile.set_position(offset);
-		fontFile >> m_fontHeaderTable.majorVersion;
-		fontFile >> m_fontHeaderTable.minorVersion;
-		fontFile >> m_fontHeaderTable.fontRevision;
-		fontFile >> m_fontHeaderTable.checksumAdjustment;
-		fontFile >> m_fontHeaderTable.magicNumber;
-		fontFile >> m_fontHeaderTable.flags;
-		fontFile >> m_fontHeaderTable.unitsPerEm;
-		fontFile >> m_fontHeaderTable.created;
-		fontFile >> m_fontHeaderTable.modified;
-		fontFile >> m_fontHeaderTable.xMin;
-		fontFile >> m_fontHeaderTable.yMin;
-		fontFile >> m_fontHeaderTable.xMax;
-		fontFile >> m_fontHeaderTable.yMax;
-		fontFile >> m_fontHeaderTable.macStyle;
-		fontFile >> m_fontHeaderTable.lowestRecPPEM;
-		fontFile >> m_fontHeaderTable.fontDirectionHint;
-		fontFile >> m_fontHeaderTable.indexToLocFormat;
-		fontFile >> m_fontHeaderTable.glyphDataFormat;
+		ByteReader tableReader = get_table_reader(fontFile, "head");
+		tableReader >> m_fontHeaderTable.majorVersion;
+		tableReader >> m_fontHeaderTable.minorVersion;
+		tableReader >> m_fontHeaderTable.fontRevision;
+		tableReader >> m_fontHeaderTable.checksumAdjustment;
+		tableReader >> m_fontHeaderTable.magicNumber;
+		tableReader >> m_fontHeaderTable.flags;
+		tableReader >> m_fontHeaderTable.unitsPerEm;
+		tableReader >> m_fontHeaderTable.created;
+		tableReader >> m_fontHeaderTable.modified;
+		tableReader >> m_fontHeaderTable.xMin;
+		tableReader >> m_fontHeaderTable.yMin;
+		tableReader >> m_fontHeaderTable.xMax;
+		tableReader >> m_fontHeaderTable.yMax;
+		tableReader >> m_fontHeaderTable.macStyle;
+		tableReader >> m_fontHeaderTable.lowestRecPPEM;
+		tableReader >> m_fontHeaderTable.fontDirectionHint;
+		tableReader >> m_fontHeaderTable.indexToLocFormat;
+		tableReader >> m_fontHeaderTable.glyphDataFormat;
+	}
+
+	void Font::create_horizontal_header_table(const File& fontFile) noexcept(util::release)
+	{
+		ByteReader tableReader = get_table_reader(fontFile, "hhea");
+		tableReader >> m_horizontalHeaderTable.majorVersion;
+		tableReader >> m_horizontalHeaderTable.minorVersion;
+		tableReader >> m_horizontalHeaderTable.ascender;
+		tableReader >> m_horizontalHeaderTable.descender;
+		tableReader >> m_horizontalHeaderTable.lineGap;
+		tableReader >> m_horizontalHeaderTable.advanceWidthMax;
+		tableReader >> m_horizontalHeaderTable.minLeftSideBearing;
+		tableReader >> m_horizontalHeaderTable.minRightSideBearing;
+		tableReader >> m_horizontalHeaderTable.xMaxExtent;
+		tableReader >> m_horizontalHeaderTable.caretSlopeRise;
+		tableReader >> m_horizontalHeaderTable.caretSlopeRun;
+		tableReader >> m_horizontalHeaderTable.caretOffset;
+		tableReader.skip(4 * sizeof(int16_t)); // reserved
+		tableReader >> m_horizontalHeaderTable.metricDataFormat;
+		tableReader >> m_horizontalHeaderTable.numberOfHMetrics;
+	}
+
+	KerningTable Font::create_kerning_table(const File& fontFile)
+	{
+		// GPOS kerning supersedes the kern table when a font has both. Kerning is optional, so a
+		// GPOS table that can't be read falls back to kern, and an unreadable kern table to no kerning.
+		if (has_table("GPOS"))
+		{
+			try
+			{
+				KerningTable kerningTable = KerningTable::from_gpos(get_table_reader(fontFile, "GPOS"));
+				if (!kerningTable.empty())
+				{
+					return kerningTable;
+				}
+			}
+			catch (const std::runtime_error&)
+			{
+			}
+		}
+		if (has_table("kern"))
+		{
+			try
+			{
+				return KerningTable::from_kern(get_table_reader(fontFile, "kern"));
+			}
+			catch (const std::runtime_error&)
+			{
+			}
+		}
+		return KerningTable{};
 	}
 
 	Font::CGIMT Font::create_cgmit(const File& fontFile) noexcept(util::release)
 	{
-		uint32_t offset = read_from_record_table("cmap")->offset;
-		fontFile.set_position(offset);
+		ByteReader tableReader = get_table_reader(fontFile, "cmap");
 		CGIMT cmapTable{};
-		fontFile >> cmapTable.version;
-		fontFile >> cmapTable.numTables;
+		tableReader >> cmapTable.version;
+		tableReader >> cmapTable.numTables;
 		cmapTable.encodingRecords.resize(cmapTable.numTables);
 		for (auto& elem : cmapTable.encodingRecords)
 		{
-			fontFile >> elem.platformID;
-			fontFile >> elem.encodingID;
-			fontFile >> elem.subtableOffset;
+			tableReader >> elem.platformID;
+			tableReader >> elem.encodingID;
+			tableReader >> elem.subtableOffset;
 		}
 		return cmapTable;
 	}
 
 	Font::IndexLocationTable Font::create_index_location_table(const File& fontFile) noexcept(util::release)
 	{
-		const uint32_t offset = read_from_record_table("loca")->offset;
+		ByteReader tableReader = get_table_reader(fontFile, "loca");
 		const size_t offsetVectorSize = static_cast<size_t>(m_maximumProfileTable.numGlyphs) + 1;
 		IndexLocationTable indexLocationTable{};
 		indexLocationTable.offsets.resize(offsetVectorSize);
 		indexLocationTable.shortVersion = m_fontHeaderTable.indexToLocFormat == 0;
-		fontFile.set_position(offset);
 		if (m_fontHeaderTable.indexToLocFormat == 0)
 		{
 			// Data is uint16_t, not uint32_t
-			fontFile.fill_vec<uint16_t>(indexLocationTable.offsets, offset);
+			tableReader.fill_vec<uint16_t>(indexLocationTable.offsets);
 		}
 		else
 		{
-			fontFile >> indexLocationTable.offsets;
+			tableReader >> indexLocationTable.offsets;
 		}
 		return indexLocationTable;
 	}
 
-	Font::CMapSubtable4 Font::create_cmap_subtable(const File& fontFile, const CGIMT& cmapTable)
-	{
-		using Iter = std::vector<Font::CharacterGlyphIndexMappingTable::EncodingRecord>::const_iterator;
-		Iter subtableInfo = std::find_if(cmapTable.encodingRecords.begin(),
-										 cmapTable.encodingRecords.end(),
-										 [](const CGIMT::EncodingRecord& rec)
-										 {
-											 return rec.platformID == 3 && rec.encodingID == 1;
-										 });
-		if (subtableInfo == cmapTable.encodingRecords.end())
-		{
-			throw std::runtime_error{ std::format("Incompatible font(cmap subtable 4 not present): {}\nFile name: {}\n", m_fontName, m_fileName) };
-		}
-		uint32_t cmapOffset = read_from_record_table("cmap")->offset;
-		uint32_t subtableOffset = cmapOffset + subtableInfo->subtableOffset;
-		fontFile.set_position(subtableOffset);
-		CMapSubtable4 cmapSubtable{};
-		fontFile >> cmapSubtable.format;
-		fontFile >> cmapSubtable.length;
-		fontFile >> cmapSubtable.language;
-		fontFile >> cmapSubtable.segCountX2;
-		fontFile >> cmapSubtable.searchRange;
-		fontFile >> cmapSubtable.entrySelector;
-		fontFile >> cmapSubtable.rangeShift;
-
-		uint16_t segCount = cmapSubtable.segCountX2 >> 1;
-		uint16_t searchRangeCheck = 2 << static_cast<uint16_t>(floor(log2(segCount)));
-		uint16_t entrySelectorCheck = static_cast<uint16_t>(log2(cmapSubtable.searchRange >> 1));
-		uint16_t rangeShiftCheck = (segCount << 1) - cmapSubtable.searchRange;
-		if (searchRangeCheck != cmapSubtable.searchRange ||
-			entrySelectorCheck != cmapSubtable.entrySelector ||
-			rangeShiftCheck != cmapSubtable.rangeShift)
-		{
-			throw std::runtime_error{ std::format("Error reading font while constructing cmap subtable 4 for font {}\nFile name: {}\n", m_fontName, m_fileName) };
-		}
-
-		cmapSubtable.endCodes.resize(segCount);
-		cmapSubtable.startCodes.resize(segCount);
-		cmapSubtable.idDeltas.resize(segCount);
-		cmapSubtable.idRangeOffsets.resize(segCount);
-		const size_t currentFilePos = fontFile.get_position();
-		err::assert<std::runtime_error>(currentFilePos <= (static_cast<size_t>(cmapOffset) +
-															static_cast<size_t>(subtableOffset) +
-															static_cast<size_t>(cmapSubtable.length)),
-										 std::format("Overshot font file for font {}\nFile name: {}\n",
-													 m_fontName,
-													 m_fileName));
-		const size_t remainder = static_cast<size_t>(cmapSubtable.length) +
-			static_cast<size_t>(cmapOffset) +
-			static_cast<size_t>(subtableOffset) -
-			currentFilePos;
-		cmapSubtable.glyphIDArray.resize(remainder);
-
-		fontFile >> cmapSubtable.endCodes;
-		fontFile >> cmapSubtable.reservedPad;
-		fontFile >> cmapSubtable.startCodes;
-		fontFile >> cmapSubtable.idDeltas;
-		cmapSubtable.rangeOffsetStartAddr = fontFile.get_position();
-		fontFile >> cmapSubtable.idRangeOffsets;
-		fontFile >> cmapSubtable.glyphIDArray;
-
-		return cmapSubtable;
-	}
-
-	void Font::create_glyph_mapping(const File& fontFile) noexcept(util::release)
-	{
-		IndexLocationTable locaTable = create_index_location_table(fontFile);
-		const uint16_t locaTableMultiplier = locaTable.shortVersion ? 2 : 1;
-		CGIMT cmapTable = create_cgmit(fontFile);
-		CMapSubtable4 cmapSubtable = create_cmap_subtable(fontFile, cmapTable);
-		const uint32_t glyfTableOffset = read_from_record_table("glyf")->offset;
-
-		const auto create_glyph_desc = [&](uint32_t glyfTableEntryOffset) -> GlyphDesc
-		{
-			using flag_t = uint8_t;
-			using coord_t = int16_t;
-			using short_coord_t = uint8_t;
-			using long_coord_t = int16_t;
-
-			// Populate GlyphDesc variable
-			GlyphDesc glyphData{};
-			fontFile.set_position(static_cast<size_t>(glyfTableOffset) + static_cast<size_t>(glyfTableEntryOffset));
-			fontFile >> glyphData.header.numberOfContours;
-			fontFile >> glyphData.header.xMin;
-			fontFile >> glyphData.header.yMin;
-			fontFile >> glyphData.header.xMax;
-			fontFile >> glyphData.header.yMax;
-			err::assert<std::runtime_error>(glyphData.header.numberOfContours >= 0, "Composite glyph description is not supported yet");
-
-			glyphData.desc.endPtsOfContours.resize(glyphData.header.numberOfContours);
-			fontFile >> glyphData.desc.endPtsOfContours;
-			fontFile >> glyphData.desc.instructionLength;
-			if (glyphData.desc.instructionLength > 0)
-			{
-				glyphData.desc.instructions.resize(glyphData.desc.instructionLength);
-				fontFile >> glyphData.desc.instructions;
-			}
-
-			std::vector<flag_t> flags{};
-			flags.resize(static_cast<size_t>(*(glyphData.desc.endPtsOfContours.rbegin())) + 1);
-			{
-				// Get flags
-				size_t i = 0;
-				while (i < flags.size())
-				{
-					flag_t flag{};
-					fontFile >> flag;
-					uint8_t additionalIterations{};
-					if (flag & REPEAT_FLAG)
-					{
-						fontFile >> additionalIterations;
-						err::assert<std::runtime_error>(i + static_cast<size_t>(additionalIterations) <= flags.size(),
-														 "More flags than there are points");
-					}
+	CharacterMap Font::create_character_map(const File& fontFile, const CGIMT& cmapTable)
+	{
+		// Full Unicode subtables first, then the BMP-only ones
+		struct SubtablePreference {
+			uint16_t platformID;
+			uint16_t encodingID;
+			uint16_t format;
+		};
+		constexpr std::array<SubtablePreference, 5> preferences{{
+			{ 3, 10, 12 },
+			{ 0, 4, 12 },
+			{ 0, 6, 13 },
+			{ 3, 1, 4 },
+			{ 0, 3, 4 }
+		}};
 
-					size_t j = 0;
-					do
-					{
-						flags[i] = flag;
-						i += 1;
-					} while (++j <= additionalIterations);
-				}
+		const ByteReader cmapReader = get_table_reader(fontFile, "cmap");
+		for (const auto& preference : preferences)
+		{
+			const auto subtableInfo = std::find_if(cmapTable.encodingRecords.begin(),
+												   cmapTable.encodingRecords.end(),
+												   [&preference](const CGIMT::EncodingRecord& rec)
+												   {
+													   return rec.platformID == preference.platformID && rec.encodingID == preference.encodingID;
+												   });
+			if (subtableInfo == cmapTable.encodingRecords.end() ||
+				cmapReader.peek<uint16_t>(subtableInfo->subtableOffset) != preference.format)
+			{
+				continue;
 			}
-			// Get points
-			const auto parse_flag = [&fontFile](flag_t flag,
-												coord_t& delta,
-												coord_t& dest,
-												const uint8_t byteFlag,
-												const uint8_t deltaFlag)
+
+			try
 			{
-				if (flag & byteFlag)
+				// Bound the reader by the subtable's own length field
+				if (preference.format == 4)
 				{
-					short_coord_t val = 0;
-					fontFile >> val;
-					if (flag & deltaFlag)
-					{
-						delta += static_cast<coord_t>(val);
-					}
-					else
-					{
-						delta -= static_cast<coord_t>(val);
-					}
-					dest = delta;
+					const uint16_t subtableLength = cmapReader.peek<uint16_t>(subtableInfo->subtableOffset + sizeof(uint16_t));
+					return CMapSubtable4{cmapReader.subreader(subtableInfo->subtableOffset, subtableLength)};
 				}
 				else
 				{
-					if (flag & deltaFlag)
-					{
-						dest = delta;
-					}
-					else
-					{
-						long_coord_t val = 0;
-						fontFile >> val;
-						delta += val;
-						dest = delta;
-					}
+					const uint32_t subtableLength = cmapReader.peek<uint32_t>(subtableInfo->subtableOffset + 2 * sizeof(uint16_t));
+					return CMapSubtable12{cmapReader.subreader(subtableInfo->subtableOffset, subtableLength)};
 				}
-			};
+			}
+			catch (const std::runtime_error& e)
+			{
+				throw std::runtime_error{ std::format("Error reading font while constructing cmap subtable {} for font {}\nFile name: {}\nError: {}\n", preference.format, m_fontName, m_fileName, e.what()) };
+			}
+		}
+
+		throw std::runtime_error{ std::format("Incompatible font(no cmap subtable 4 or 12 present): {}\nFile name: {}\n", m_fontName, m_fileName) };
+	}
+
+	ByteReader Font::get_glyph_reader(const glyph_id_t glyphID) const
+	{
+		// Glyph IDs also come from composite glyphs in the file, so these are checked even in release builds
+		if (static_cast<size_t>(glyphID) + 1 >= m_indexLocationTable.offsets.size())
+		{
+			throw std::runtime_error{"Glyph ID out of range"};
+		}
+		const size_t locaTableMultiplier = m_indexLocationTable.shortVersion ? 2 : 1;
+		const size_t glyfTableEntryOffset = locaTableMultiplier * m_indexLocationTable.offsets[glyphID];
+		const size_t glyfTableEntryEnd = locaTableMultiplier * m_indexLocationTable.offsets[glyphID + 1];
+		if (glyfTableEntryOffset > glyfTableEntryEnd || glyfTableEntryEnd > m_glyfReader.size())
+		{
+			throw std::runtime_error{"Malformed loca table"};
+		}
+		return m_glyfReader.subreader(glyfTableEntryOffset, glyfTableEntryEnd - glyfTableEntryOffset);
+	}
 
-			std::vector<coord_t> xCoords{};
-			xCoords.resize(flags.size());
-			coord_t xCoordTracker = 0;
-			for (size_t i = 0; i < flags.size(); i += 1)
-			{
-				parse_flag(flags[i],
-						   xCoordTracker,
-						   xCoords[i],
-						   X_SHORT_VECTOR,
-						   X_IS_SAME_OR_POSITIVE_X_SHORT_VECTOR);
-			}
-
-			std::vector<coord_t> yCoords{};
-			yCoords.resize(flags.size());
-			coord_t yCoordTracker = 0;
-			for (size_t i = 0; i < flags.size(); i += 1)
-			{
-				parse_flag(flags[i],
-						   yCoordTracker,
-						   yCoords[i],
-						   Y_SHORT_VECTOR,
-						   Y_IS_SAME_OR_POSITIVE_Y_SHORT_VECTOR);
-			}
-
-			const auto calculate_missing_on_curve_points_and_combine = [](std::vector<uint16_t>& endOfContourIndices,
-																		  const std::vector<flag_t>& flags,
-																		  const std::vector<coord_t>& xCoords,
-																		  const std::vector<coord_t>& yCoords) -> std::vector<FontPoint>
-			{
-				//GlyphDesc::SimpleGlyphDesc desc = descInOut;
-				//FontPointList& pointList = desc.points;
-
-				std::vector<FontPoint> fontPoints; 
-				fontPoints.reserve(flags.size());
-
-				// May or may not be needed
-				//{
-				//	uint16_t startIndex = 0;
-				//	uint16_t change = 0;
-				//	// Why do I do this?
-				//	for (auto& endIndex : desc.endPtsOfContours)
-				//	{
-				//		// If the first point is not on the curve
-				//		[[unlikely]] if ((pointList[startIndex].flag & ON_CURVE_POINT) != ON_CURVE_POINT)
-				//		{
-				//			// If the last point is off-curve, make the first point in pointList be on curve
-				//			if ((pointList[endIndex].flag & ON_CURVE_POINT) != ON_CURVE_POINT)
-				//			{
-				//				// Not sure why this uses midpoint
-				//				pointList.emplace(pointList.begin() + startIndex,
-				//								  ON_CURVE_POINT,
-				//								  math::midpoint(pointList[startIndex].data, pointList[endIndex].data));
-				//				++change;
-				//			}
-				//			else
-				//			{
-				//				// Otherwise, move the last point to be the first point
-				//				pointList.insert(pointList.begin() + startIndex, *(pointList.begin() + endIndex + change));
-				//				pointList.erase(pointList.begin() + endIndex + change + 1);
-				//			}
-				//		}
-				//		endIndex += change;
-				//		startIndex = endIndex + 1;
-				//	}
-				//}
-				
-				// Fill-in understood on-curve points
-				size_t start = 0;
-				uint16_t newVertexCount = 0;
-				for (uint16_t& endIndex : endOfContourIndices)
+	GlyphOutlineView Font::decode_glyph_outline(const glyph_id_t glyphID, const uint16_t depth)
+	{
+		using flag_t = uint8_t;
+		using coord_t = int16_t;
+		using short_coord_t = uint8_t;
+		using long_coord_t = int16_t;
+
+		ByteReader glyphReader = get_glyph_reader(glyphID);
+		// Glyphs without an outline (e.g. space) have no data at all
+		if (glyphReader.size() == 0)
+		{
+			m_glyphOutlines.allocate(glyphID, GlyphBounds{}, glyphID, 0, 0);
+			m_glyphOutlines.commit(glyphID);
+			return m_glyphOutlines.get_outline(glyphID);
+		}
+		int16_t numberOfContours{};
+		GlyphBounds bounds{};
+		glyphReader >> numberOfContours;
+		glyphReader >> bounds.xMin;
+		glyphReader >> bounds.yMin;
+		glyphReader >> bounds.xMax;
+		glyphReader >> bounds.yMax;
+		if (numberOfContours < 0)
+		{
+			return decode_composite_glyph_outline(glyphReader, glyphID, bounds, depth);
+		}
+		if (numberOfContours == 0)
+		{
+			m_glyphOutlines.allocate(glyphID, bounds, glyphID, 0, 0);
+			m_glyphOutlines.commit(glyphID);
+			return m_glyphOutlines.get_outline(glyphID);
+		}
+
+		const size_t contourCount = static_cast<size_t>(numberOfContours);
+		const size_t pointCount = static_cast<size_t>(glyphReader.peek<uint16_t>(glyphReader.get_position() + (contourCount - 1) * sizeof(uint16_t))) + 1;
+		GlyphOutlineBuffer outline = m_glyphOutlines.allocate(glyphID, bounds, glyphID, pointCount, contourCount);
+		glyphReader.get_data(outline.contourEnds.data(), contourCount);
+		// The contour ends and flags come straight from the file, so they're checked even in release builds
+		for (size_t i = 1; i < contourCount; i += 1)
+		{
+			if (outline.contourEnds[i - 1] >= outline.contourEnds[i])
+			{
+				throw std::runtime_error{"Contour end points are not increasing"};
+			}
+		}
+		// Hinting isn't supported, skip the instructions
+		glyphReader.skip(glyphReader.get_data<uint16_t>());
+
+		// The full flags are kept in onCurve while the coordinates are decoded, then reduced to the on-curve bit
+		std::span<flag_t> flags = outline.onCurve;
+		{
+			// Get flags
+			size_t i = 0;
+			while (i < flags.size())
+			{
+				flag_t flag{};
+				glyphReader >> flag;
+				uint8_t additionalIterations{};
+				if (flag & REPEAT_FLAG)
 				{
-					const size_t end = static_cast<size_t>(endIndex) + 1;
-					for (size_t i = start; i < (end - 1); i += 1)
-					{
-						fontPoints.emplace_back(flags[i],
-												math::Point<int16_t, 2>{xCoords[i], yCoords[i]});
-						if (((flags[i] & ON_CURVE_POINT) != ON_CURVE_POINT) &&
-							((flags[i + 1] & ON_CURVE_POINT) != ON_CURVE_POINT))
-						{
-							const math::Point<int16_t, 2> p0{xCoords[i], yCoords[i]};
-							const math::Point<int16_t, 2> p1{xCoords[i + 1], yCoords[i + 1]};
-							fontPoints.emplace_back(ON_CURVE_POINT,
-													math::midpoint(p0, p1));
-							newVertexCount += 1;
-						}
-					}
-					fontPoints.emplace_back(flags[endIndex],
-											math::Point<int16_t, 2>{xCoords[endIndex], yCoords[endIndex]});
-					if (((flags[start] & ON_CURVE_POINT) != ON_CURVE_POINT) &&
-						((flags[endIndex] & ON_CURVE_POINT) != ON_CURVE_POINT))
+					glyphReader >> additionalIterations;
+					if (i + static_cast<size_t>(additionalIterations) >= flags.size())
 					{
-						const math::Point<int16_t, 2> p0{xCoords[start], yCoords[start]};
-						const math::Point<int16_t, 2> p1{xCoords[endIndex], yCoords[endIndex]};
-						fontPoints.emplace_back(ON_CURVE_POINT,
-												math::midpoint(p0, p1));
-						newVertexCount += 1;
+						throw std::runtime_error{"More flags than there are points"};
 					}
-					endIndex += newVertexCount;
-					start = end;
 				}
-				
-				return fontPoints;
-			};
 
-			glyphData.desc.points = std::move(calculate_missing_on_curve_points_and_combine(glyphData.desc.endPtsOfContours,
-																							flags,
-																							xCoords,
-																							yCoords));
-			return glyphData;
+				size_t j = 0;
+				do
+				{
+					flags[i] = flag;
+					i += 1;
+				} while (++j <= additionalIterations);
+			}
+		}
+		// Get points
+		const auto parse_flag = [&glyphReader](flag_t flag,
+											coord_t& delta,
+											coord_t& dest,
+											const uint8_t byteFlag,
+											const uint8_t deltaFlag)
+		{
+			if (flag & byteFlag)
+			{
+				short_coord_t val = 0;
+				glyphReader >> val;
+				if (flag & deltaFlag)
+				{
+					delta += static_cast<coord_t>(val);
+				}
+				else
+				{
+					delta -= static_cast<coord_t>(val);
+				}
+				dest = delta;
+			}
+			else
+			{
+				if (flag & deltaFlag)
+				{
+					dest = delta;
+				}
+				else
+				{
+					long_coord_t val = 0;
+					glyphReader >> val;
+					delta += val;
+					dest = delta;
+				}
+			}
 		};
 
-		const auto create_glyph_desc_and_insert = [&](const wchar_t letter)
+		coord_t xCoordTracker = 0;
+		for (size_t i = 0; i < flags.size(); i += 1)
+		{
+			parse_flag(flags[i],
+					   xCoordTracker,
+					   outline.x[i],
+					   X_SHORT_VECTOR,
+					   X_IS_SAME_OR_POSITIVE_X_SHORT_VECTOR);
+		}
+
+		coord_t yCoordTracker = 0;
+		for (size_t i = 0; i < flags.size(); i += 1)
+		{
+			parse_flag(flags[i],
+					   yCoordTracker,
+					   outline.y[i],
+					   Y_SHORT_VECTOR,
+					   Y_IS_SAME_OR_POSITIVE_Y_SHORT_VECTOR);
+		}
+
+		for (flag_t& flag : flags)
+		{
+			flag &= ON_CURVE_POINT;
+		}
+		m_glyphOutlines.commit(glyphID);
+		return m_glyphOutlines.get_outline(glyphID);
+	}
+
+	GlyphOutlineView Font::decode_composite_glyph_outline(ByteReader& glyphReader,
+														  const glyph_id_t glyphID,
+														  const GlyphBounds& bounds,
+														  const uint16_t depth)
+	{
+		// maxp's maxComponentDepth is not always accurate, this only guards against cycles. Components
+		// come straight from the file, so this is checked even in release builds.
+		constexpr uint16_t maxComponentDepth = 16;
+		if (depth >= maxComponentDepth)
+		{
+			throw std::runtime_error{"Composite glyph nesting is too deep"};
+		}
+
+		const auto read_f2dot14 = [&glyphReader]() -> float
 		{
-			[[unlikely]] if (letter == u'\0') return;
-			uint16_t c = std::bit_cast<uint16_t>(letter);
+			return static_cast<float>(glyphReader.get_data<int16_t>()) / 16384.0f;
+		};
 
-			const auto get_index = [&]() -> size_t
+		std::vector<ComponentGlyph> components{};
+		glyph_id_t metricsGlyphID = glyphID;
+		uint16_t flags{};
+		do
+		{
+			ComponentGlyph component{};
+			glyphReader >> flags;
+			glyphReader >> component.glyphIndex;
+			component.flags = flags;
+			if (flags & ARG_1_AND_2_ARE_WORDS)
 			{
-				size_t i = 0;
-				for (i; i < cmapSubtable.endCodes.size(); i++)
+				if (flags & ARGS_ARE_XY_VALUES)
 				{
-					if (c > cmapSubtable.endCodes[i]) continue;
-					else break;
+					component.argument1 = glyphReader.get_data<int16_t>();
+					component.argument2 = glyphReader.get_data<int16_t>();
 				}
-				return i;
-			};
+				else
+				{
+					component.argument1 = glyphReader.get_data<uint16_t>();
+					component.argument2 = glyphReader.get_data<uint16_t>();
+				}
+			}
+			else
+			{
+				if (flags & ARGS_ARE_XY_VALUES)
+				{
+					component.argument1 = glyphReader.get_data<int8_t>();
+					component.argument2 = glyphReader.get_data<int8_t>();
+				}
+				else
+				{
+					component.argument1 = glyphReader.get_data<uint8_t>();
+					component.argument2 = glyphReader.get_data<uint8_t>();
+				}
+			}
+
+			if (flags & WE_HAVE_A_SCALE)
+			{
+				component.xx = read_f2dot14();
+				component.yy = component.xx;
+			}
+			else if (flags & WE_HAVE_AN_X_AND_Y_SCALE)
+			{
+				component.xx = read_f2dot14();
+				component.yy = read_f2dot14();
+			}
+			else if (flags & WE_HAVE_A_TWO_BY_TWO)
+			{
+				component.xx = read_f2dot14();
+				component.xy = read_f2dot14();
+				component.yx = read_f2dot14();
+				component.yy = read_f2dot14();
+			}
 
-			size_t i = get_index();
-			if (i == cmapSubtable.endCodes.size() - 1)
+			if (flags & USE_MY_METRICS)
 			{
-				return;
+				metricsGlyphID = component.glyphIndex;
 			}
+			components.push_back(component);
+		} while (flags & MORE_COMPONENTS);
+		// Hinting isn't supported, so any trailing instructions are left unread
+
+		// Components come out of the store already flattened, so shared and nested components are only decoded once
+		std::vector<GlyphOutlineView> componentOutlines{};
+		componentOutlines.reserve(components.size());
+		size_t pointCount = 0;
+		size_t contourCount = 0;
+		for (const ComponentGlyph& component : components)
+		{
+			componentOutlines.push_back(get_glyph_outline(component.glyphIndex, depth + 1));
+			pointCount += componentOutlines.back().point_count();
+			contourCount += componentOutlines.back().contour_count();
+		}
+		if (pointCount > std::numeric_limits<uint16_t>::max() + size_t{1})
+		{
+			throw std::runtime_error{"Composite glyph has too many points"};
+		}
+
+		GlyphOutlineBuffer outline = m_glyphOutlines.allocate(glyphID, bounds, metricsGlyphID, pointCount, contourCount);
+		size_t pointOffset = 0;
+		size_t contourOffset = 0;
+		for (size_t c = 0; c < components.size(); c += 1)
+		{
+			const ComponentGlyph& component = components[c];
+			const GlyphOutlineView& componentOutline = componentOutlines[c];
+			const auto transform = [&component, &componentOutline](const size_t i) -> std::pair<float, float>
+			{
+				const float x = static_cast<float>(componentOutline.x[i]);
+				const float y = static_cast<float>(componentOutline.y[i]);
+				return {component.xx * x + component.yx * y, component.xy * x + component.yy * y};
+			};
 
-			if (cmapSubtable.startCodes[i] <= c)
+			float dx{};
+			float dy{};
+			if (component.flags & ARGS_ARE_XY_VALUES)
 			{
-				uint32_t glyfTableEntryOffset = 0;
-				uint16_t locaTableOffset = 0;
-				if (cmapSubtable.idRangeOffsets[i] != 0)
+				dx = static_cast<float>(component.argument1);
+				dy = static_cast<float>(component.argument2);
+				// Offsets are unscaled unless the font explicitly asks otherwise
+				if ((component.flags & SCALED_COMPONENT_OFFSET) && !(component.flags & UNSCALED_COMPONENT_OFFSET))
 				{
-					// Determine offset into glyphIDArray
-					const uint16_t cOffset = c - cmapSubtable.startCodes[i];
-					const uint16_t glyphIDOffset = (cmapSubtable.idRangeOffsets[i] >> 1) + cOffset +
-						static_cast<const uint16_t>(i) - static_cast<uint16_t>(cmapSubtable.idRangeOffsets.size());
-					locaTableOffset = cmapSubtable.glyphIDArray[glyphIDOffset];
-					// If the offset is not 0, then add the corresponding idDelta value modulo 65536
-					if (locaTableOffset != 0)
-					{
-						locaTableOffset += cmapSubtable.idDeltas[i];
-					}
-					else
-					{
-						// Missing glyph
-						return;
-					}
-					locaTableOffset &= 0xFFFF;
+					const float x = dx;
+					const float y = dy;
+					dx = component.xx * x + component.yx * y;
+					dy = component.xy * x + component.yy * y;
 				}
-				else
+			}
+			else
+			{
+				// Align a point of the component with a point already placed in the composite
+				const size_t parentPoint = static_cast<size_t>(component.argument1);
+				const size_t childPoint = static_cast<size_t>(component.argument2);
+				if (parentPoint >= pointOffset || childPoint >= componentOutline.point_count())
 				{
-					locaTableOffset = (c + cmapSubtable.idDeltas[i]) & 0xFFFF;
+					throw std::runtime_error{"Composite glyph anchor point out of range"};
 				}
-				glyfTableEntryOffset = locaTableMultiplier * locaTable.offsets[locaTableOffset];
-
-				err::assert<std::runtime_error>(glyfTableEntryOffset != 0,
-												 "Should not be adding missing glyph to charGlyphMap.");
+				const auto [childX, childY] = transform(childPoint);
+				dx = static_cast<float>(outline.x[parentPoint]) - childX;
+				dy = static_cast<float>(outline.y[parentPoint]) - childY;
+			}
 
-				m_charGlyphMap.insert({ letter, create_glyph_desc(glyfTableEntryOffset) });
+			for (size_t i = 0; i < componentOutline.contour_count(); i += 1)
+			{
+				outline.contourEnds[contourOffset + i] = static_cast<uint16_t>(pointOffset + componentOutline.contourEnds[i]);
 			}
-		};
+			for (size_t i = 0; i < componentOutline.point_count(); i += 1)
+			{
+				const auto [x, y] = transform(i);
+				outline.x[pointOffset + i] = static_cast<int16_t>(std::lround(x + dx));
+				outline.y[pointOffset + i] = static_cast<int16_t>(std::lround(y + dy));
+				outline.onCurve[pointOffset + i] = componentOutline.onCurve[i];
+			}
+			pointOffset += componentOutline.point_count();
+			contourOffset += componentOutline.contour_count();
+		}
+		m_glyphOutlines.commit(glyphID);
+		return m_glyphOutlines.get_outline(glyphID);
+	}
 
-		m_missingGlyph = create_glyph_desc(0);
-		for (const auto& elem : keyToWChar)
+	glyph_id_t Font::get_glyph_index(const char32_t letter) const noexcept
+	{
+		// Glyph 0 is the missing glyph
+		[[unlikely]] if (letter == U'\0') return 0;
+		return m_characterMap.get_glyph_index(letter);
+	}
+
+	void Font::build_cmap_lookup_table()
+	{
+		m_characterMap.build_lookup_table();
+	}
+
+	GlyphOutlineView Font::get_glyph_outline(const glyph_id_t glyphID, const uint16_t depth)
+	{
+		if (m_glyphOutlines.contains(glyphID))
+		{
+			return m_glyphOutlines.get_outline(glyphID);
+		}
+		return decode_glyph_outline(glyphID, depth);
+	}
+
+	const GlyphMesh& Font::get_glyph_mesh(const glyph_id_t glyphID, const lod_bucket_t bucket)
+	{
+		const uint32_t meshKey = get_mesh_key(glyphID, bucket);
+		if (const GlyphMesh* mesh = m_glyphMeshes.find(meshKey))
+		{
+			return *mesh;
+		}
+
+		GlyphMesh mesh{};
+		if (!m_meshCache.load(meshKey, mesh))
 		{
-			create_glyph_desc_and_insert(elem.second);
-			create_glyph_desc_and_insert(shift_down(elem.first));
+			mesh = triangulate_glyph(get_glyph_outline(glyphID), get_flattening_tolerance(bucket));
+			m_meshCache.append(meshKey, mesh);
 		}
+		return add_glyph_mesh(glyphID, bucket, std::move(mesh));
+	}
+
+	uint32_t Font::get_mesh_key(const glyph_id_t glyphID, const lod_bucket_t bucket) const noexcept
+	{
+		return (static_cast<uint32_t>(bucket) << 16) | static_cast<uint32_t>(glyphID);
+	}
+
+	const GlyphMesh& Font::add_glyph_mesh(const glyph_id_t glyphID, const lod_bucket_t bucket, GlyphMesh&& mesh)
+	{
+		const size_t meshSize = mesh.memory_size();
+		// The missing glyph stands in for every unsupported character, so it always stays around
+		const bool pinned = glyphID == 0;
+		return m_glyphMeshes.insert(get_mesh_key(glyphID, bucket), std::move(mesh), meshSize, pinned);
 	}
 
-	void Font::triangulate_characters()
+	void Font::set_mesh_budget(const size_t bytes) noexcept
 	{
-		m_missingGlyphMesh = std::move(get_on_curve_mesh(get_curve_set(m_missingGlyph.desc)));
+		m_glyphMeshes.set_budget(bytes);
+	}
+
+	const LruStatistics& Font::get_mesh_statistics() const noexcept
+	{
+		return m_glyphMeshes.statistics();
+	}
+
+	void Font::load_glyphs()
+	{
+		const lod_bucket_t bucket = get_lod_bucket(m_pointSize);
+		get_glyph_mesh(0, bucket);
 		for (const auto& elem : keyToWChar)
 		{
-			const Key characterKey = elem.first;
-			const wchar_t character = elem.second;
-			CurveSet outline = get_glyph(character);
-			m_characterMeshMap.emplace(character, std::move(get_on_curve_mesh(outline)));
-			outline = get_glyph(shift_down(characterKey));
-			m_characterMeshMap.emplace(shift_down(characterKey), std::move(get_on_curve_mesh(outline)));
+			get_glyph_mesh(get_glyph_index(elem.second), bucket);
+			get_glyph_mesh(get_glyph_index(shift_down(elem.first)), bucket);
+		}
+	}
+
+	void Font::preload(std::span<const char32_t> characters, ThreadPool& executor)
+	{
+		const lod_bucket_t bucket = get_lod_bucket(m_pointSize);
+		std::vector<glyph_id_t> glyphIDs{};
+		glyphIDs.reserve(characters.size());
+		for (const char32_t character : characters)
+		{
+			const glyph_id_t glyphID = get_glyph_index(character);
+			if (!m_glyphMeshes.contains(get_mesh_key(glyphID, bucket)))
+			{
+				glyphIDs.push_back(glyphID);
+			}
 		}
+		std::sort(glyphIDs.begin(), glyphIDs.end());
+		glyphIDs.erase(std::unique(glyphIDs.begin(), glyphIDs.end()), glyphIDs.end());
+
+		// Meshes stored by an earlier run need no triangulation at all
+		std::erase_if(glyphIDs,
+					  [this, bucket](const glyph_id_t glyphID)
+					  {
+						  GlyphMesh mesh{};
+						  if (!m_meshCache.load(get_mesh_key(glyphID, bucket), mesh))
+						  {
+							  return false;
+						  }
+						  add_glyph_mesh(glyphID, bucket, std::move(mesh));
+						  return true;
+					  });
+
+		// Outlines are written to the shared arena, so they are decoded here. Decoding is a small
+		// fraction of the cost of triangulating, which only reads the (stable) outline views.
+		std::vector<GlyphOutlineView> outlines{};
+		outlines.reserve(glyphIDs.size());
+		for (const glyph_id_t glyphID : glyphIDs)
+		{
+			outlines.push_back(get_glyph_outline(glyphID));
+		}
+
+		const float tolerance = get_flattening_tolerance(bucket);
+		std::vector<GlyphMesh> meshes(glyphIDs.size());
+		executor.parallel_for(glyphIDs.size(),
+							  [this, &outlines, &meshes, tolerance](const size_t i)
+							  {
+								  meshes[i] = triangulate_glyph(outlines[i], tolerance);
+							  });
+
+		// Written out before the meshes are handed to the memory cache, which may evict some of them right away
+		std::vector<uint32_t> meshKeys{};
+		std::vector<const GlyphMesh*> newMeshes{};
+		meshKeys.reserve(glyphIDs.size());
+		newMeshes.reserve(glyphIDs.size());
+		for (size_t i = 0; i < glyphIDs.size(); i++)
+		{
+			meshKeys.push_back(get_mesh_key(glyphIDs[i], bucket));
+			newMeshes.push_back(&meshes[i]);
+		}
+		m_meshCache.append(meshKeys, newMeshes);
+
+		for (size_t i = 0; i < glyphIDs.size(); i++)
+		{
+			add_glyph_mesh(glyphIDs[i], bucket, std::move(meshes[i]));
+		}
+	}
+
+	float Font::get_flattening_tolerance(const lod_bucket_t bucket) const noexcept
+	{
+		// Curves may be off by a quarter of a pixel at the largest size of the bucket
+		constexpr float tolerancePixels = 0.25f;
+		const float pixelsPerEm = static_cast<float>(uint32_t{1} << bucket);
+		return tolerancePixels * static_cast<float>(m_fontHeaderTable.unitsPerEm) / pixelsPerEm;
 	}
 
-	DelaunayMesh Font::get_on_curve_mesh(const CurveSet& characterCurves) const
+	std::vector<std::vector<point_t>> Font::flatten_outline(const GlyphOutlineView& outline, const float tolerance) const
 	{
-		std::vector<point_t> points{};
-		for (size_t i = 0; i < characterCurves.size(); i += 1)
+		using font_point_t = std::pair<float, float>;
+
+		const float unitsPerEm = static_cast<float>(m_fontHeaderTable.unitsPerEm);
+		const auto midpoint = [](const font_point_t& p0, const font_point_t& p1) -> font_point_t
+		{
+			return {0.5f * (p0.first + p1.first), 0.5f * (p0.second + p1.second)};
+		};
+
+		std::vector<std::vector<point_t>> loops{};
+		loops.reserve(outline.contour_count());
+		size_t startIndex = 0;
+		for (const uint16_t contourEnd : outline.contourEnds)
 		{
-			if (characterCurves.size() != 0)
+			const size_t lastIndex = contourEnd;
+			const size_t count = lastIndex + 1 - startIndex;
+			const auto point_at = [&outline, startIndex, count](const size_t i) -> font_point_t
+			{
+				const size_t index = startIndex + i % count;
+				return {static_cast<float>(outline.x[index]), static_cast<float>(outline.y[index])};
+			};
+			const auto on_curve_at = [&outline, startIndex, count](const size_t i) -> bool
+			{
+				return outline.onCurve[startIndex + i % count] != 0;
+			};
+			startIndex = lastIndex + 1;
+
+			std::vector<point_t> loop{};
+			const auto add_point = [&loop, unitsPerEm](const font_point_t& p)
 			{
-				for (size_t j = 0; j < characterCurves[i].size(); j += 1)
+				const point_t point{p.first / unitsPerEm, -1.0f * p.second / unitsPerEm};
+				// If they're close enough to compare equal...
+				if (loop.size() == 0 ||
+					!((*loop.rbegin())[0] == point[0] && (*loop.rbegin())[1] == point[1]))
 				{
-					const GFXFontPoint& fontPoint = characterCurves[i][j];
-					if (fontPoint.onCurve)
-					{
-						if (points.size() == 0)
-						{
-							points.push_back(fontPoint.data);
-						}
-						else
-						{
-							// If they're close enough to compare equal...
-							const point_t& meshPoint = *(points.rbegin());
-							if (!(meshPoint[0] == fontPoint.data[0] &&
-								  meshPoint[1] == fontPoint.data[1]))
-							{
-								points.push_back(fontPoint.data);
-							}
-						}
-					}
+					loop.push_back(point);
+				}
+			};
+			// A quadratic segment strays at most |p0 - 2 * p1 + p2| / 4 from its chord, and splitting it
+			// into n equal parameter steps divides that by n^2
+			const auto add_curve = [&add_point, tolerance](const font_point_t& p0, const font_point_t& p1, const font_point_t& p2)
+			{
+				// Bounds the vertex count of a single curve for absurdly small tolerances
+				constexpr size_t maxCurveSegments = 64;
+				const float ddx = p0.first - 2.0f * p1.first + p2.first;
+				const float ddy = p0.second - 2.0f * p1.second + p2.second;
+				const float deviation = 0.25f * std::sqrt(ddx * ddx + ddy * ddy);
+				const size_t segments = std::clamp(static_cast<size_t>(std::ceil(std::sqrt(deviation / tolerance))),
+												   size_t{1},
+												   maxCurveSegments);
+				for (size_t i = 1; i <= segments; i++)
+				{
+					const float t = static_cast<float>(i) / static_cast<float>(segments);
+					const float mt = 1.0f - t;
+					add_point({mt * mt * p0.first + 2.0f * mt * t * p1.first + t * t * p2.first,
+							   mt * mt * p0.second + 2.0f * mt * t * p1.second + t * t * p2.second});
+				}
+			};
+
+			if (count < 2)
+			{
+				if (count == 1 && on_curve_at(0))
+				{
+					add_point(point_at(0));
+					loops.push_back(std::move(loop));
+				}
+				continue;
+			}
+
+			// Start on an on-curve point, or on the implied one between the first two points if there is none
+			size_t first = 0;
+			while (first < count && !on_curve_at(first))
+			{
+				first++;
+			}
+			font_point_t current{};
+			if (first == count)
+			{
+				first = 0;
+				current = midpoint(point_at(0), point_at(1));
+			}
+			else
+			{
+				current = point_at(first);
+			}
+			add_point(current);
+
+			for (size_t k = 1; k <= count; k++)
+			{
+				const size_t i = first + k;
+				if (on_curve_at(i))
+				{
+					current = point_at(i);
+					add_point(current);
+					continue;
 				}
+
+				// Two off-curve points in a row imply an on-curve point halfway between them
+				const font_point_t control = point_at(i);
+				const bool nextOnCurve = on_curve_at(i + 1);
+				const font_point_t end = nextOnCurve ? point_at(i + 1) : midpoint(control, point_at(i + 1));
+				add_curve(current, control, end);
+				current = end;
+				if (nextOnCurve)
+				{
+					k++;
+				}
+			}
+
+			// The walk ends where it started
+			if (loop.size() > 1 && (*loop.rbegin())[0] == loop[0][0] && (*loop.rbegin())[1] == loop[0][1])
+			{
+				loop.pop_back();
 			}
+			loops.push_back(std::move(loop));
+		}
+		return loops;
+	}
+
+	DelaunayMesh Font::get_outline_mesh(const std::vector<std::vector<point_t>>& loops) const
+	{
+		size_t pointCount = 0;
+		for (const std::vector<point_t>& loop : loops)
+		{
+			pointCount += loop.size();
 		}
 
-		return DelaunayMesh{points};
+		// Nothing to triangulate for empty glyphs (e.g. space)
+		if (pointCount < 3)
+		{
+			return DelaunayMesh{};
+		}
+
+		return DelaunayMesh{loops, InsertionOrder::Brio};
 	};
 
-	std::vector<font_triangle_t> Font::get_triangles(const wchar_t character) noexcept
+	GlyphMesh Font::triangulate_glyph(const GlyphOutlineView& outline, const float tolerance) const
 	{
-		const auto meshIter = m_characterMeshMap.find(character);
-		const DelaunayMesh& mesh = meshIter != m_characterMeshMap.end() ? meshIter->second : m_missingGlyphMesh;
-		std::vector<triangle_t> meshTriangles = std::move(mesh.get_triangles());
-		const std::vector<point_t>& meshPoints = mesh.get_points();
-		std::vector<font_triangle_t> fontTriangles{};
-		fontTriangles.reserve(meshTriangles.size());
+		const std::vector<std::vector<point_t>> loops = flatten_outline(outline, tolerance);
 
-		const auto has_ghost_vertex = [](const point_t& p0,
-										 const point_t& p1,
-										 const point_t& p2) -> bool
+		// Small outlines are ear clipped, which skips building the Delaunay mesh and its maps. Ear
+		// clipping is quadratic (it overtook the Delaunay triangulation at around 300 points for Lato
+		// and Source Code Pro), so larger outlines stay with the Delaunay triangulation, as do glyphs
+		// with many holes to bridge and the ones ear clipping can't handle.
+		constexpr size_t earClipMaxPoints = 256;
+		constexpr size_t earClipMaxLoops = 16;
+		size_t pointCount = 0;
+		for (const std::vector<point_t>& loop : loops)
 		{
-			return clm::util::disjunction(is_ghost(p0),
-										  is_ghost(p1),
-										  is_ghost(p2));
-		};
+			pointCount += loop.size();
+		}
+		if (pointCount <= earClipMaxPoints && loops.size() <= earClipMaxLoops)
+		{
+			if (std::optional<std::vector<uint32_t>> indices = ear_clip(loops))
+			{
+				GlyphMesh glyphMesh{};
+				glyphMesh.vertices.reserve(pointCount);
+				for (const std::vector<point_t>& loop : loops)
+				{
+					glyphMesh.vertices.insert(glyphMesh.vertices.end(), loop.begin(), loop.end());
+				}
+				glyphMesh.indices = std::move(*indices);
+				return glyphMesh;
+			}
+		}
 
-		for (const auto& triangle : meshTriangles)
+		const DelaunayMesh mesh = get_outline_mesh(loops);
+		const std::span<const std::array<uint32_t, 3>> meshTriangles = mesh.get_triangle_view();
+		const std::vector<point_t>& meshPoints = mesh.get_points();
+
+		// Keep only the real vertices, the mesh has no triangles left that use the ghost vertex
+		constexpr uint32_t ghostIndex = std::numeric_limits<uint32_t>::max();
+		GlyphMesh glyphMesh{};
+		std::vector<uint32_t> vertexIndices(meshPoints.size(), ghostIndex);
+		glyphMesh.vertices.reserve(meshPoints.size());
+		for (size_t i = 0; i < meshPoints.size(); i++)
 		{
-			const auto& vertices = triangle.get_points();
-			if (!has_ghost_vertex(meshPoints[vertices[0]],
-								  meshPoints[vertices[1]],
-								  meshPoints[vertices[2]]))
+			if (!is_ghost(meshPoints[i]))
 			{
-				fontTriangles.emplace_back(meshPoints[vertices[0]],
-										   meshPoints[vertices[1]],
-										   meshPoints[vertices[2]]);
+				vertexIndices[i] = static_cast<uint32_t>(glyphMesh.vertices.size());
+				glyphMesh.vertices.push_back(meshPoints[i]);
 			}
 		}
 
+		glyphMesh.indices.reserve(3 * meshTriangles.size());
+		for (const std::array<uint32_t, 3>& triangle : meshTriangles)
+		{
+			glyphMesh.indices.push_back(vertexIndices[triangle[0]]);
+			glyphMesh.indices.push_back(vertexIndices[triangle[1]]);
+			glyphMesh.indices.push_back(vertexIndices[triangle[2]]);
+		}
+
+		return glyphMesh;
+	}
+
+	std::vector<font_triangle_t> Font::get_triangles(const char32_t character)
+	{
+		return get_triangles(character, m_pointSize);
+	}
+
+	std::vector<font_triangle_t> Font::get_triangles(const char32_t character, const float pointSize)
+	{
+		const GlyphMesh& mesh = get_glyph_mesh(get_glyph_index(character), get_lod_bucket(pointSize));
+		std::vector<font_triangle_t> fontTriangles{};
+		fontTriangles.reserve(mesh.indices.size() / 3);
+		for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+		{
+			fontTriangles.emplace_back(mesh.vertices[mesh.indices[i]],
+									   mesh.vertices[mesh.indices[i + 1]],
+									   mesh.vertices[mesh.indices[i + 2]]);
+		}
+
 		return fontTriangles;
 	}
+
+	point_t Font::layout_and_tessellate(const std::u32string_view text,
+										const point_t origin,
+										std::vector<point_t>& outVertices,
+										IndexBuffer& outIndices)
+	{
+		const lod_bucket_t bucket = get_lod_bucket(m_pointSize);
+		const float unitsPerEm = static_cast<float>(m_fontHeaderTable.unitsPerEm);
+		point_t pen = origin;
+		bool lineStart = true;
+		glyph_id_t previousGlyphID = 0;
+		for (const char32_t character : text)
+		{
+			if (character == U'\n')
+			{
+				pen = point_t{origin[0], pen[1] + static_cast<float>(get_line_height()) / unitsPerEm};
+				lineStart = true;
+				continue;
+			}
+
+			const glyph_id_t glyphID = get_glyph_index(character);
+			if (!lineStart)
+			{
+				pen[0] += static_cast<float>(m_kerningTable.get_kerning(previousGlyphID, glyphID)) / unitsPerEm;
+			}
+			lineStart = false;
+			previousGlyphID = glyphID;
+			// Only valid until the next mesh is added, so it's used up before moving on
+			const GlyphMesh& mesh = get_glyph_mesh(glyphID, bucket);
+			const uint32_t baseIndex = static_cast<uint32_t>(outVertices.size());
+			for (const point_t& vertex : mesh.vertices)
+			{
+				outVertices.push_back(point_t{vertex[0] + pen[0], vertex[1] + pen[1]});
+			}
+			for (const uint32_t index : mesh.indices)
+			{
+				outIndices.push_back(baseIndex + index);
+			}
+			pen[0] += static_cast<float>(get_advance_width(glyphID)) / unitsPerEm;
+		}
+		return pen;
+	}
+
+	int32_t Font::get_advance_width(const glyph_id_t glyphID) const noexcept
+	{
+		return m_horizontalMetrics.get_advance_width(glyphID);
+	}
+
+	int32_t Font::get_line_height() const noexcept
+	{
+		// descender is negative
+		return static_cast<int32_t>(m_horizontalHeaderTable.ascender) - m_horizontalHeaderTable.descender + m_horizontalHeaderTable.lineGap;
+	}
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 #ifndef FONT_H
 #define FONT_H
 #include <vector>
+#include <array>
 #include <string>
+#include <string_view>
 #include <format>
 #include <unordered_map>
 #include <exception>
@@ -12,8 +14,16 @@
 #include <clmUtil/clm_util.h>
 
 #include <File.h>
+#include <ByteReader.h>
 #include <Keyboard.h>
 #include <Delaunay.h>
+#include <CMap.h>
+#include <GlyphOutline.h>
+#include <ThreadPool.h>
+#include <MeshCache.h>
+#include <LruCache.h>
+#include <Metrics.h>
+#include <IndexBuffer.h>
 
 typedef unsigned long DWORD;
 
@@ -25,47 +35,88 @@ constexpr const uint8_t X_IS_SAME_OR_POSITIVE_X_SHORT_VECTOR = 0x10;
 constexpr const uint8_t Y_IS_SAME_OR_POSITIVE_Y_SHORT_VECTOR = 0x20;
 constexpr const uint8_t OVERLAP_SIMPLE = 0x40;
 
+constexpr const uint16_t ARG_1_AND_2_ARE_WORDS = 0x0001;
+constexpr const uint16_t ARGS_ARE_XY_VALUES = 0x0002;
+constexpr const uint16_t ROUND_XY_TO_GRID = 0x0004;
+constexpr const uint16_t WE_HAVE_A_SCALE = 0x0008;
+constexpr const uint16_t MORE_COMPONENTS = 0x0020;
+constexpr const uint16_t WE_HAVE_AN_X_AND_Y_SCALE = 0x0040;
+constexpr const uint16_t WE_HAVE_A_TWO_BY_TWO = 0x0080;
+constexpr const uint16_t WE_HAVE_INSTRUCTIONS = 0x0100;
+constexpr const uint16_t USE_MY_METRICS = 0x0200;
+constexpr const uint16_t OVERLAP_COMPOUND = 0x0400;
+constexpr const uint16_t SCALED_COMPONENT_OFFSET = 0x0800;
+constexpr const uint16_t UNSCALED_COMPONENT_OFFSET = 0x1000;
+
 namespace clm {
 	using font_triangle_t = std::tuple<point_t, point_t, point_t>;
 
-	struct FontPoint {
-		uint8_t flag;
-		math::Point<int16_t, 2> data;
+	// Eager decodes and triangulates every keyboard character when the font is constructed,
+	// Lazy only reads the tables needed to find glyphs and decodes each glyph on first use
+	enum class GlyphLoading {
+		Eager, Lazy
 	};
 
-	using GFXPointType = math::Point2f;
-	struct GFXFontPoint {
-		bool onCurve;
-		GFXPointType data;
+	// Full verifies every table checksum and the file checksum, HeaderOnly only checks that the
+	// table directory is sane (tables within the file, required tables present) and None trusts
+	// the file completely, e.g. for fonts that have already been verified
+	enum class ValidationLevel {
+		Full, HeaderOnly, None
 	};
-	using PointList = std::vector<GFXFontPoint>;
-	using CurveSet = std::vector<PointList>;
 
 	class Font {
 	public:
 		Font() noexcept = default;
-		Font(std::string, const float);
+		// Meshes are persisted in the mesh cache file (if one is given) and reused by later runs
+		Font(std::string, const float, const GlyphLoading = GlyphLoading::Lazy, std::string = "", const ValidationLevel = ValidationLevel::Full);
 		~Font() = default;
-		Font(const Font&) noexcept = default;
+		// A copy would duplicate every decoded outline and mesh and write to the same mesh cache file
+		Font(const Font&) = delete;
 		Font(Font&&) noexcept = default;
-		Font& operator=(Font&) noexcept = default;
+		Font& operator=(const Font&) = delete;
 		Font& operator=(Font&&) noexcept = default;
 
 		void set_pointsize(const float pointSize) noexcept { m_pointSize = pointSize; }
-		CurveSet get_glyph(const wchar_t) noexcept;
-		std::vector<font_triangle_t> get_triangles(const wchar_t) noexcept;
+		GlyphOutlineView get_glyph(const char32_t);
+		std::vector<font_triangle_t> get_triangles(const char32_t);
+		// Meshes are built per level of detail, so several sizes can be drawn side by side
+		std::vector<font_triangle_t> get_triangles(const char32_t, const float);
+		// Appends the meshes of every character of the string to the buffers, with each glyph moved to
+		// the pen position (in ems, starting at origin, y pointing down). The pen moves by the advance
+		// width plus the pair kerning, and newlines move it to the start of the next line. Indices
+		// refer to the vertex buffer (16 bit while they fit) and the existing contents are kept, so the
+		// buffers can be reused across calls. Returns the pen position after the last character.
+		point_t layout_and_tessellate(const std::u32string_view, const point_t, std::vector<point_t>&, IndexBuffer&);
+		// Upper bound for the memory held by meshes (in bytes), the default is 64MB
+		void set_mesh_budget(const size_t) noexcept;
+		const LruStatistics& get_mesh_statistics() const noexcept;
+		// Trade 128KB for single-load character lookups
+		void build_cmap_lookup_table();
+		// Decodes the glyphs of the given characters and triangulates them on the executor's threads
+		void preload(std::span<const char32_t>, ThreadPool&);
 	private:
-		uint32_t calc_checksum(const File&, uint32_t, size_t) const noexcept;
+		uint32_t calc_checksum(const File&, size_t, size_t) const noexcept(util::release);
 		uint32_t get_checksum_adjustment(const File&, size_t) const;
-		void validate_font(const File&);
-		void create_offset_table(const File&);
+		void validate_font(const File&, const ValidationLevel);
+		void create_offset_table(ByteReader&);
 		void verify_offset_table_vals();
-		void create_table_records(const File&) noexcept(util::release);
+		void create_table_records(ByteReader&) noexcept(util::release);
 		void create_maximum_profile_table(const File&) noexcept(util::release);
 		void create_font_header_table(const File&) noexcept(util::release);
+		void create_horizontal_header_table(const File&) noexcept(util::release);
+		KerningTable create_kerning_table(const File&);
 
-		void triangulate_characters();
-		DelaunayMesh get_on_curve_mesh(const CurveSet&) const;
+		void load_glyphs();
+		// Curves are flattened so that they are off by less than tolerance (in font units)
+		std::vector<std::vector<point_t>> flatten_outline(const GlyphOutlineView&, const float) const;
+		using lod_bucket_t = uint8_t;
+		static constexpr size_t s_lodBucketCount = 16;
+		lod_bucket_t get_lod_bucket(const float) const noexcept;
+		float get_flattening_tolerance(const lod_bucket_t) const noexcept;
+		DelaunayMesh get_outline_mesh(const std::vector<std::vector<point_t>>&) const;
+		GlyphMesh triangulate_glyph(const GlyphOutlineView&, const float) const;
+		uint64_t get_font_key() const noexcept;
+		uint64_t get_tessellation_key() const noexcept;
 
 		struct CharacterGlyphIndexMappingTable {
 			uint16_t version;
@@ -80,23 +131,7 @@ namespace clm {
 		using CGIMT = CharacterGlyphIndexMappingTable;
 		CGIMT create_cgmit(const File&) noexcept(util::release);
 
-		struct CMapSubtable4 {
-			uint16_t format;
-			uint16_t length;
-			uint16_t language;
-			uint16_t segCountX2;
-			uint16_t searchRange;
-			uint16_t entrySelector;
-			uint16_t rangeShift;
-			std::vector<uint16_t> endCodes;
-			uint16_t reservedPad;
-			std::vector<uint16_t> startCodes;
-			std::vector<int16_t> idDeltas;
-			std::vector<uint16_t> idRangeOffsets;
-			std::vector<uint16_t> glyphIDArray;
-			size_t rangeOffsetStartAddr;
-		};
-		CMapSubtable4 create_cmap_subtable(const File&, const CGIMT&);
+		CharacterMap create_character_map(const File&, const CGIMT&);
 
 		struct IndexLocationTable {
 			bool shortVersion = false;
@@ -104,15 +139,24 @@ namespace clm {
 		};
 		IndexLocationTable create_index_location_table(const File&) noexcept(util::release);
 
-		void create_glyph_mapping(const File&) noexcept(util::release);
+		glyph_id_t get_glyph_index(const char32_t) const noexcept;
+		ByteReader get_glyph_reader(const glyph_id_t) const;
+		const GlyphMesh& get_glyph_mesh(const glyph_id_t, const lod_bucket_t);
+		uint32_t get_mesh_key(const glyph_id_t, const lod_bucket_t) const noexcept;
+		const GlyphMesh& add_glyph_mesh(const glyph_id_t, const lod_bucket_t, GlyphMesh&&);
+		// In font units
+		int32_t get_advance_width(const glyph_id_t) const noexcept;
+		int32_t get_line_height() const noexcept;
 
 		struct TableRecord;
 		using TRIter = std::vector<TableRecord>::iterator;
 		TRIter read_from_record_table(std::string);
+		bool has_table(const std::string&) const noexcept;
+		ByteReader get_table_reader(const File&, std::string);
 
 		std::string m_fontName;
 		std::string m_fileName;
-		float m_pointSize;
+		float m_pointSize = 0.0f;
 		struct TableRecord {
 			std::string tableTag = "";
 			uint32_t checksum = 0;
@@ -157,28 +201,36 @@ namespace clm {
 			int16_t indexToLocFormat = 0;
 			int16_t glyphDataFormat = 0;
 		} m_fontHeaderTable;
-		struct GlyphDesc {
-			struct GlyphHeader {
-				int16_t numberOfContours{};
-				int16_t xMin{};
-				int16_t yMin{};
-				int16_t xMax{};
-				int16_t yMax{};
-			} header;
-
-			struct SimpleGlyphDesc {
-				bool byteCoordinates{ true };
-				std::vector<uint16_t> endPtsOfContours{};
-				uint16_t instructionLength{};
-				std::vector<uint8_t> instructions{};
-				std::vector<FontPoint> points{};
-
-				//SimpleGlyphDesc() = default;
-				//~SimpleGlyphDesc() = default;
-			} desc;
-		} m_missingGlyph;
-		std::unordered_map<wchar_t, GlyphDesc> m_charGlyphMap;
-		CurveSet get_curve_set(const GlyphDesc::SimpleGlyphDesc&) const noexcept;
+		struct HorizontalHeaderTable {
+			uint16_t majorVersion = 0;
+			uint16_t minorVersion = 0;
+			int16_t ascender = 0;
+			int16_t descender = 0;
+			int16_t lineGap = 0;
+			uint16_t advanceWidthMax = 0;
+			int16_t minLeftSideBearing = 0;
+			int16_t minRightSideBearing = 0;
+			int16_t xMaxExtent = 0;
+			int16_t caretSlopeRise = 0;
+			int16_t caretSlopeRun = 0;
+			int16_t caretOffset = 0;
+			int16_t metricDataFormat = 0;
+			uint16_t numberOfHMetrics = 0;
+		} m_horizontalHeaderTable;
+		struct ComponentGlyph {
+			glyph_id_t glyphIndex{};
+			uint16_t flags{};
+			int32_t argument1{};
+			int32_t argument2{};
+			// x' = xx * x + yx * y + dx, y' = xy * x + yy * y + dy
+			float xx{ 1.0f };
+			float xy{ 0.0f };
+			float yx{ 0.0f };
+			float yy{ 1.0f };
+		};
+		GlyphOutlineView decode_glyph_outline(const glyph_id_t, const uint16_t);
+		GlyphOutlineView decode_composite_glyph_outline(ByteReader&, const glyph_id_t, const GlyphBounds&, const uint16_t);
+		GlyphOutlineView get_glyph_outline(const glyph_id_t, const uint16_t = 0);
 
 		struct OffsetTable {
 			std::uint32_t scalarType = 0;
@@ -188,8 +240,18 @@ namespace clm {
 			std::uint16_t rangeShift = 0;
 		} m_offsetTable;
 
-		std::unordered_map<wchar_t, DelaunayMesh> m_characterMeshMap;
-		DelaunayMesh m_missingGlyphMesh;
+		File m_fontFile;
+		ByteReader m_glyfReader;
+		IndexLocationTable m_indexLocationTable;
+		CharacterMap m_characterMap;
+		HorizontalMetrics m_horizontalMetrics;
+		KerningTable m_kerningTable;
+
+		// Decoded glyphs and their meshes, keyed by glyph ID (0 is the missing glyph)
+		GlyphOutlineStore m_glyphOutlines;
+		// Keyed by get_mesh_key (glyph ID and level of detail)
+		LruCache<uint32_t, GlyphMesh> m_glyphMeshes{64 * 1024 * 1024};
+		MeshCache m_meshCache;
 	};
 }
 #endif
\ No newline at end of file
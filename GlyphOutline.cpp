@@ -0,0 +1,117 @@
+#include "GlyphOutline.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <clmUtil/clm_err.h>
+
+namespace clm {
+	GlyphOutlineStore::Chunk::Chunk(const size_t points, const size_t contours)
+		:
+		pointCapacity(points),
+		contourCapacity(contours),
+		x(std::make_unique_for_overwrite<int16_t[]>(points)),
+		y(std::make_unique_for_overwrite<int16_t[]>(points)),
+		onCurve(std::make_unique_for_overwrite<uint8_t[]>(points)),
+		contourEnds(std::make_unique_for_overwrite<uint16_t[]>(contours))
+	{}
+
+	GlyphOutlineStore::Chunk::Chunk(const Chunk& other)
+		:
+		Chunk(other.pointCapacity, other.contourCapacity)
+	{
+		pointsUsed = other.pointsUsed;
+		contoursUsed = other.contoursUsed;
+		std::memcpy(x.get(), other.x.get(), pointsUsed * sizeof(int16_t));
+		std::memcpy(y.get(), other.y.get(), pointsUsed * sizeof(int16_t));
+		std::memcpy(onCurve.get(), other.onCurve.get(), pointsUsed * sizeof(uint8_t));
+		std::memcpy(contourEnds.get(), other.contourEnds.get(), contoursUsed * sizeof(uint16_t));
+	}
+
+	GlyphOutlineStore::Chunk& GlyphOutlineStore::Chunk::operator=(const Chunk& other)
+	{
+		if (this != &other)
+		{
+			*this = Chunk{other};
+		}
+		return *this;
+	}
+
+	GlyphOutlineStore::GlyphOutlineStore(const size_t glyphCount)
+		:
+		m_entries(glyphCount)
+	{}
+
+	bool GlyphOutlineStore::contains(const glyph_id_t glyphID) const noexcept
+	{
+		return static_cast<size_t>(glyphID) < m_entries.size() && m_entries[glyphID].committed;
+	}
+
+	GlyphOutlineView GlyphOutlineStore::get_outline(const glyph_id_t glyphID) const noexcept(util::release)
+	{
+		err::assert<std::runtime_error>(contains(glyphID), "Glyph outline has not been decoded");
+		const Entry& entry = m_entries[glyphID];
+		GlyphOutlineView view{};
+		view.bounds = entry.bounds;
+		view.metricsGlyphID = entry.metricsGlyphID;
+		if (entry.pointCount == 0 && entry.contourCount == 0)
+		{
+			return view;
+		}
+
+		const Chunk& chunk = m_chunks[entry.chunk];
+		view.x = std::span<const int16_t>{chunk.x.get() + entry.pointOffset, entry.pointCount};
+		view.y = std::span<const int16_t>{chunk.y.get() + entry.pointOffset, entry.pointCount};
+		view.onCurve = std::span<const uint8_t>{chunk.onCurve.get() + entry.pointOffset, entry.pointCount};
+		view.contourEnds = std::span<const uint16_t>{chunk.contourEnds.get() + entry.contourOffset, entry.contourCount};
+		return view;
+	}
+
+	GlyphOutlineBuffer GlyphOutlineStore::allocate(const glyph_id_t glyphID,
+												   const GlyphBounds& bounds,
+												   const glyph_id_t metricsGlyphID,
+												   const size_t pointCount,
+												   const size_t contourCount)
+	{
+		err::assert<std::runtime_error>(static_cast<size_t>(glyphID) < m_entries.size(), "Glyph ID out of range");
+		err::assert<std::runtime_error>(!m_entries[glyphID].committed, "Glyph outline is already stored");
+
+		Entry& entry = m_entries[glyphID];
+		entry.bounds = bounds;
+		entry.metricsGlyphID = metricsGlyphID;
+		entry.pointCount = static_cast<uint32_t>(pointCount);
+		entry.contourCount = static_cast<uint32_t>(contourCount);
+		if (pointCount == 0 && contourCount == 0)
+		{
+			return GlyphOutlineBuffer{};
+		}
+
+		// Glyphs are never split across chunks, oversized ones get a chunk of their own
+		if (m_chunks.empty() ||
+			m_chunks.back().pointCapacity - m_chunks.back().pointsUsed < pointCount ||
+			m_chunks.back().contourCapacity - m_chunks.back().contoursUsed < contourCount)
+		{
+			m_chunks.emplace_back(std::max(s_chunkPoints, pointCount), std::max(s_chunkContours, contourCount));
+		}
+
+		Chunk& chunk = m_chunks.back();
+		entry.chunk = static_cast<uint32_t>(m_chunks.size() - 1);
+		entry.pointOffset = static_cast<uint32_t>(chunk.pointsUsed);
+		entry.contourOffset = static_cast<uint32_t>(chunk.contoursUsed);
+		chunk.pointsUsed += pointCount;
+		chunk.contoursUsed += contourCount;
+
+		GlyphOutlineBuffer buffer{};
+		buffer.x = std::span<int16_t>{chunk.x.get() + entry.pointOffset, pointCount};
+		buffer.y = std::span<int16_t>{chunk.y.get() + entry.pointOffset, pointCount};
+		buffer.onCurve = std::span<uint8_t>{chunk.onCurve.get() + entry.pointOffset, pointCount};
+		buffer.contourEnds = std::span<uint16_t>{chunk.contourEnds.get() + entry.contourOffset, contourCount};
+		return buffer;
+	}
+
+	void GlyphOutlineStore::commit(const glyph_id_t glyphID) noexcept(util::release)
+	{
+		err::assert<std::runtime_error>(static_cast<size_t>(glyphID) < m_entries.size(), "Glyph ID out of range");
+		m_entries[glyphID].committed = true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef GLYPH_OUTLINE_H
+#define GLYPH_OUTLINE_H
+#include <vector>
+#include <span>
+#include <memory>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+
+#include <clmUtil/clm_util.h>
+
+#include <CMap.h>
+
+namespace clm {
+	struct GlyphBounds {
+		int16_t xMin{};
+		int16_t yMin{};
+		int16_t xMax{};
+		int16_t yMax{};
+	};
+
+	// Non-owning view of a decoded glyph outline in font units. Points are in file order
+	// (implied on-curve points are not stored), contourEnds holds the index of the last point
+	// of each contour. Views stay valid for the lifetime of the store they came from.
+	struct GlyphOutlineView {
+		std::span<const int16_t> x{};
+		std::span<const int16_t> y{};
+		std::span<const uint8_t> onCurve{};
+		std::span<const uint16_t> contourEnds{};
+		GlyphBounds bounds{};
+		// Glyph whose advance and side bearing this glyph uses (USE_MY_METRICS)
+		glyph_id_t metricsGlyphID{};
+
+		size_t point_count() const noexcept { return x.size(); }
+		size_t contour_count() const noexcept { return contourEnds.size(); }
+		bool empty() const noexcept { return contourEnds.empty(); }
+	};
+
+	// Writable counterpart of GlyphOutlineView handed out while a glyph is being decoded
+	struct GlyphOutlineBuffer {
+		std::span<int16_t> x{};
+		std::span<int16_t> y{};
+		std::span<uint8_t> onCurve{};
+		std::span<uint16_t> contourEnds{};
+	};
+
+	// Arena for the outlines of one font. Coordinates, on-curve bits and contour ends of all
+	// glyphs are packed into structure-of-arrays chunks, and each glyph ID maps to its slice of
+	// a chunk. Chunks never grow or move, so views handed out earlier are unaffected by later
+	// allocations.
+	class GlyphOutlineStore {
+	public:
+		GlyphOutlineStore() noexcept = default;
+		GlyphOutlineStore(const size_t);
+		~GlyphOutlineStore() noexcept = default;
+		GlyphOutlineStore(const GlyphOutlineStore&) = default;
+		GlyphOutlineStore(GlyphOutlineStore&&) noexcept = default;
+		GlyphOutlineStore& operator=(const GlyphOutlineStore&) = default;
+		GlyphOutlineStore& operator=(GlyphOutlineStore&&) noexcept = default;
+
+		size_t glyph_count() const noexcept { return m_entries.size(); }
+		bool contains(const glyph_id_t) const noexcept;
+		GlyphOutlineView get_outline(const glyph_id_t) const noexcept(util::release);
+		// Reserves space for a glyph, the outline becomes visible once commit() is called
+		GlyphOutlineBuffer allocate(const glyph_id_t, const GlyphBounds&, const glyph_id_t, const size_t, const size_t);
+		void commit(const glyph_id_t) noexcept(util::release);
+	private:
+		struct Chunk {
+			Chunk() noexcept = default;
+			Chunk(const size_t, const size_t);
+			~Chunk() noexcept = default;
+			Chunk(const Chunk&);
+			Chunk(Chunk&&) noexcept = default;
+			Chunk& operator=(const Chunk&);
+			Chunk& operator=(Chunk&&) noexcept = default;
+
+			size_t pointCapacity = 0;
+			size_t contourCapacity = 0;
+			size_t pointsUsed = 0;
+			size_t contoursUsed = 0;
+			std::unique_ptr<int16_t[]> x{};
+			std::unique_ptr<int16_t[]> y{};
+			std::unique_ptr<uint8_t[]> onCurve{};
+			std::unique_ptr<uint16_t[]> contourEnds{};
+		};
+		struct Entry {
+			uint32_t chunk = 0;
+			uint32_t pointOffset = 0;
+			uint32_t pointCount = 0;
+			uint32_t contourOffset = 0;
+			uint32_t contourCount = 0;
+			GlyphBounds bounds{};
+			glyph_id_t metricsGlyphID = 0;
+			bool committed = false;
+		};
+
+		static constexpr size_t s_chunkPoints = 16384;
+		static constexpr size_t s_chunkContours = 2048;
+
+		std::vector<Chunk> m_chunks;
+		std::vector<Entry> m_entries;
+	};
+}
+
+#endif
\ No newline at end of file
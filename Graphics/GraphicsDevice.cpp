@@ -324,9 +324,12 @@ namespace clm {
 		createInfo.hinstance = GetModuleHandle(nullptr);
 		err::check_ret_val(vkCreateWin32SurfaceKHR(m_instance, &createInfo, nullptr, &m_surface),
 						   "Failed to create window surface.");
-		m_vertices.push_back({{0.0f, -0.5f}, {1.0f, 0.0f, 0.0f}});
-		m_vertices.push_back({{0.5f, 0.5f}, {0.0f, 1.0f, 0.0f}});
-		m_vertices.push_back({{-0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}});
+		m_vertices.push_back({{0.0f, -0.5f}});
+		m_vertices.push_back({{0.5f, 0.5f}});
+		m_vertices.push_back({{-0.5f, 0.5f}});
+		m_indices.push_back(0);
+		m_indices.push_back(1);
+		m_indices.push_back(2);
 
 		pick_physical_device();
 		create_logical_device();
@@ -337,6 +340,7 @@ namespace clm {
 		create_framebuffers();
 		create_command_pool();
 		create_vertex_buffer();
+		create_index_buffer();
 		create_command_buffers();
 		create_sync_objects();
 	}
@@ -346,6 +350,7 @@ namespace clm {
 		vkDeviceWaitIdle(m_device);
 		cleanup_swapchain();
 		destroy_vertex_buffer();
+		destroy_index_buffer();
 		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
 		{
 			vkDestroySemaphore(m_device, m_renderFinishedSemaphores[i], nullptr);
@@ -876,14 +881,26 @@ namespace clm {
 		throw std::runtime_error{"Failed to find suitable memory type."};
 	}
 
-	void GraphicsDevice::create_vertex_buffer()
+	void GraphicsDevice::create_host_buffer(const void* contents,
+											const size_t size,
+											const VkBufferUsageFlags usage,
+											VkBuffer& buffer,
+											VkDeviceMemory& bufferMemory)
 	{
+		// Vulkan doesn't allow empty buffers, nothing is drawn from them anyway
+		if (size == 0)
+		{
+			buffer = VK_NULL_HANDLE;
+			bufferMemory = VK_NULL_HANDLE;
+			return;
+		}
+
 		VkBufferCreateInfo bufferCreateInfo{};
 		bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 		bufferCreateInfo.pNext = nullptr;
 		bufferCreateInfo.flags = 0;
-		bufferCreateInfo.size = static_cast<VkDeviceSize>(m_vertices.size() * sizeof(m_vertices[0]));
-		bufferCreateInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+		bufferCreateInfo.size = static_cast<VkDeviceSize>(size);
+		bufferCreateInfo.usage = usage;
 		bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 		bufferCreateInfo.queueFamilyIndexCount = 0;
 		bufferCreateInfo.pQueueFamilyIndices = nullptr;
@@ -891,11 +908,11 @@ namespace clm {
 		err::check_ret_val(vkCreateBuffer(m_device,
 										  &bufferCreateInfo,
 										  nullptr,
-										  &m_vertexBuffer),
-						   "Failed to create vertex buffer.");
+										  &buffer),
+						   "Failed to create buffer.");
 
 		VkMemoryRequirements memRequirements{};
-		vkGetBufferMemoryRequirements(m_device, m_vertexBuffer, &memRequirements);
+		vkGetBufferMemoryRequirements(m_device, buffer, &memRequirements);
 
 		VkMemoryAllocateInfo allocInfo{};
 		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
@@ -905,21 +922,39 @@ namespace clm {
 		err::check_ret_val(vkAllocateMemory(m_device,
 											&allocInfo,
 											nullptr,
-											&m_vertexBufferMemory),
-						   "Failed to allocate vertex buffer memory.");
+											&bufferMemory),
+						   "Failed to allocate buffer memory.");
 
-		vkBindBufferMemory(m_device, m_vertexBuffer, m_vertexBufferMemory, 0);
+		vkBindBufferMemory(m_device, buffer, bufferMemory, 0);
 
 		void* data{};
-		vkMapMemory(m_device, m_vertexBufferMemory, 0, bufferCreateInfo.size, 0, &data);
-		std::memcpy(data, m_vertices.data(), static_cast<size_t>(bufferCreateInfo.size));
-		vkUnmapMemory(m_device, m_vertexBufferMemory);
+		vkMapMemory(m_device, bufferMemory, 0, bufferCreateInfo.size, 0, &data);
+		std::memcpy(data, contents, size);
+		vkUnmapMemory(m_device, bufferMemory);
+	}
+
+	void GraphicsDevice::create_vertex_buffer()
+	{
+		create_host_buffer(m_vertices.data(),
+						   m_vertices.size() * sizeof(gfx::Vertex),
+						   VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+						   m_vertexBuffer,
+						   m_vertexBufferMemory);
+	}
+
+	void GraphicsDevice::create_index_buffer()
+	{
+		create_host_buffer(m_indices.data(),
+						   m_indices.byte_size(),
+						   VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+						   m_indexBuffer,
+						   m_indexBufferMemory);
 	}
 
 	void GraphicsDevice::create_graphics_pipeline()
 	{
-		std::vector<char> vertShaderCode = read_file(get_shader_path("vert.spv"));
-		std::vector<char> fragShaderCode = read_file(get_shader_path("frag.spv"));
+		std::vector<char> vertShaderCode = read_file(get_shader_path("fontVert.spv"));
+		std::vector<char> fragShaderCode = read_file(get_shader_path("fontFrag.spv"));
 		VkShaderModule vertShaderModule = create_shader_module(vertShaderCode);
 		VkShaderModule fragShaderModule = create_shader_module(fragShaderCode);
 
@@ -938,7 +973,7 @@ namespace clm {
 		VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
 
 		VkVertexInputBindingDescription bindingDescription = gfx::Vertex::get_binding_description();
-		std::array<VkVertexInputAttributeDescription, 2> attributeDescription = gfx::Vertex::get_attribute_description();
+		std::array<VkVertexInputAttributeDescription, 1> attributeDescription = gfx::Vertex::get_attribute_description();
 
 		VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
 		vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -1158,18 +1193,26 @@ namespace clm {
 			vkCmdBindPipeline(m_commandBuffers[i],
 							  VK_PIPELINE_BIND_POINT_GRAPHICS,
 							  m_graphicsPipeline);
-			VkBuffer vertexBuffers[] = {m_vertexBuffer};
-			VkDeviceSize offsets[] = {0};
-			vkCmdBindVertexBuffers(m_commandBuffers[i],
-								   0,
-								   1,
-								   vertexBuffers,
-								   offsets);
-			vkCmdDraw(m_commandBuffers[i],
-					  static_cast<uint32_t>(m_vertices.size()),
-					  1,
-					  0,
-					  0);
+			if (!m_indices.empty())
+			{
+				VkBuffer vertexBuffers[] = {m_vertexBuffer};
+				VkDeviceSize offsets[] = {0};
+				vkCmdBindVertexBuffers(m_commandBuffers[i],
+									   0,
+									   1,
+									   vertexBuffers,
+									   offsets);
+				vkCmdBindIndexBuffer(m_commandBuffers[i],
+									 m_indexBuffer,
+									 0,
+									 m_indices.index_type() == IndexType::UInt16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32);
+				vkCmdDrawIndexed(m_commandBuffers[i],
+								 static_cast<uint32_t>(m_indices.size()),
+								 1,
+								 0,
+								 0,
+								 0);
+			}
 			vkCmdEndRenderPass(m_commandBuffers[i]);
 			err::check_ret_val(vkEndCommandBuffer(m_commandBuffers[i]),
 							   "Failed to record command buffer.");
@@ -1213,18 +1256,15 @@ namespace clm {
 		}
 	}
 
-	void GraphicsDevice::draw_triangles(const std::vector<font_triangle_t>& triangles)
+	void GraphicsDevice::draw_mesh(const std::vector<point_t>& vertices, const IndexBuffer& indices)
 	{
-		m_vertices.resize(3 * triangles.size());
-		for (const auto& triangle : triangles)
+		m_vertices.clear();
+		m_vertices.reserve(vertices.size());
+		for (const point_t& vertex : vertices)
 		{
-			m_vertices.push_back({std::get<0>(triangle),
-								 {1.0f, 0.0f, 0.0f}});
-			m_vertices.push_back({std::get<1>(triangle),
-									{0.0f, 1.0f, 0.0f}});
-			m_vertices.push_back({std::get<2>(triangle),
-									{0.0f, 0.0f, 1.0f}});
+			m_vertices.push_back({vertex});
 		}
+		m_indices = indices;
 		m_updateVertexBuffer = true;
 	}
 
@@ -1317,10 +1357,13 @@ namespace clm {
 		vkDeviceWaitIdle(m_device);
 		cleanup_swapchain();
 
-		if (m_updateVertexBuffer)
+		// The mesh buffers outlive the swapchain unless there's a new mesh to upload
+		const bool updateMeshBuffers = m_updateVertexBuffer;
+		if (updateMeshBuffers)
 		{
 			m_updateVertexBuffer = false;
 			destroy_vertex_buffer();
+			destroy_index_buffer();
 		}
 
 		create_swapchain();
@@ -1328,7 +1371,11 @@ namespace clm {
 		create_render_pass();
 		create_graphics_pipeline();
 		create_framebuffers();
-		create_vertex_buffer();
+		if (updateMeshBuffers)
+		{
+			create_vertex_buffer();
+			create_index_buffer();
+		}
 		create_command_buffers();
 	}
 
@@ -1358,6 +1405,12 @@ namespace clm {
 		vkFreeMemory(m_device, m_vertexBufferMemory, nullptr);
 	}
 
+	void GraphicsDevice::destroy_index_buffer()
+	{
+		vkDestroyBuffer(m_device, m_indexBuffer, nullptr);
+		vkFreeMemory(m_device, m_indexBufferMemory, nullptr);
+	}
+
 	void GraphicsDevice::resize_buffer(const math::Rect_t& rect)
 	{
 
@@ -49,6 +49,7 @@ namespace clm {
 #include <vulkan/vulkan_win32.h>
 
 #include "Font.h"
+#include "IndexBuffer.h"
 #include "BuildSystemInput.h"
 
 // 
@@ -80,9 +81,9 @@ constexpr const size_t MAX_FRAMES_IN_FLIGHT = 2;
 std::vector<char> read_file(const std::string& filename);
 
 namespace clm::gfx {
+	// Glyph meshes only carry positions, the color is up to the shader
 	struct Vertex {
 		point_t position;
-		clm::math::Point3f color;
 
 		static VkVertexInputBindingDescription get_binding_description()
 		{
@@ -94,20 +95,15 @@ namespace clm::gfx {
 			return bindingDescription;
 		}
 
-		static std::array<VkVertexInputAttributeDescription, 2> get_attribute_description()
+		static std::array<VkVertexInputAttributeDescription, 1> get_attribute_description()
 		{
-			std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions{};
+			std::array<VkVertexInputAttributeDescription, 1> attributeDescriptions{};
 
 			attributeDescriptions[0].binding = 0;
 			attributeDescriptions[0].location = 0;
 			attributeDescriptions[0].format = VK_FORMAT_R32G32_SFLOAT;
 			attributeDescriptions[0].offset = offsetof(Vertex, position);
 
-			attributeDescriptions[1].binding = 0;
-			attributeDescriptions[1].location = 1;
-			attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-			attributeDescriptions[1].offset = offsetof(Vertex, color);
-
 			return attributeDescriptions;
 		}
 	};
@@ -122,7 +118,8 @@ namespace clm {
 		GraphicsDevice& operator=(const GraphicsDevice&) = delete;
 		GraphicsDevice(GraphicsDevice&&) = delete;
 		GraphicsDevice& operator=(GraphicsDevice&&) = delete;
-		void draw_triangles(const std::vector<font_triangle_t>&);
+		// Shared vertices plus triangle list indices, e.g. from Font::layout_and_tessellate
+		void draw_mesh(const std::vector<point_t>&, const IndexBuffer&);
 		void draw_frame();
 
 		void resize_buffer(const math::Rect_t&);
@@ -158,6 +155,9 @@ namespace clm {
 		std::vector<gfx::Vertex> m_vertices;
 		VkBuffer m_vertexBuffer;
 		VkDeviceMemory m_vertexBufferMemory;
+		IndexBuffer m_indices;
+		VkBuffer m_indexBuffer;
+		VkDeviceMemory m_indexBufferMemory;
 
 		struct QueueFamilyIndices {
 			std::optional<std::uint32_t> graphicsFamily;
@@ -211,7 +211,9 @@ namespace clm {
 		void create_image_views();
 		void create_render_pass();
 		uint32_t find_memory_type(uint32_t, VkMemoryPropertyFlags);
+		void create_host_buffer(const void*, const size_t, const VkBufferUsageFlags, VkBuffer&, VkDeviceMemory&);
 		void create_vertex_buffer();
+		void create_index_buffer();
 		void create_graphics_pipeline();
 		VkShaderModule create_shader_module(const std::vector<char>& code);
 		void create_framebuffers();
@@ -222,6 +224,7 @@ namespace clm {
 		void cleanup_swapchain();
 
 		void destroy_vertex_buffer();
+		void destroy_index_buffer();
 
 		static VKAPI_ATTR VkBool32 VKAPI_CALL debug_callback([[maybe_unused]] VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
 															 [[maybe_unused]] VkDebugUtilsMessageTypeFlagsEXT messageType,
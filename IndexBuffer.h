@@ -0,0 +1,88 @@
+#ifndef INDEX_BUFFER_H
+#define INDEX_BUFFER_H
+#include <vector>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+
+namespace clm {
+	enum class IndexType {
+		UInt16, UInt32
+	};
+
+	// Triangle list indices for upload. They're stored as 16 bit values until an index no longer
+	// fits, at which point everything is widened to 32 bit. clear() keeps the memory of both, so a
+	// buffer that's refilled every frame stops allocating once it has grown.
+	class IndexBuffer {
+	public:
+		IndexBuffer() noexcept = default;
+		~IndexBuffer() noexcept = default;
+		IndexBuffer(const IndexBuffer&) = default;
+		IndexBuffer(IndexBuffer&&) noexcept = default;
+		IndexBuffer& operator=(const IndexBuffer&) = default;
+		IndexBuffer& operator=(IndexBuffer&&) noexcept = default;
+
+		void push_back(const uint32_t index)
+		{
+			if (m_indexType == IndexType::UInt16)
+			{
+				[[likely]] if (index <= std::numeric_limits<uint16_t>::max())
+				{
+					m_indices16.push_back(static_cast<uint16_t>(index));
+					return;
+				}
+				widen();
+			}
+			m_indices32.push_back(index);
+		}
+		void reserve(const size_t count)
+		{
+			if (m_indexType == IndexType::UInt16)
+			{
+				m_indices16.reserve(count);
+			}
+			else
+			{
+				m_indices32.reserve(count);
+			}
+		}
+		void clear() noexcept
+		{
+			m_indices16.clear();
+			m_indices32.clear();
+			m_indexType = IndexType::UInt16;
+		}
+
+		uint32_t operator[](const size_t i) const noexcept
+		{
+			return m_indexType == IndexType::UInt16 ? m_indices16[i] : m_indices32[i];
+		}
+		size_t size() const noexcept
+		{
+			return m_indexType == IndexType::UInt16 ? m_indices16.size() : m_indices32.size();
+		}
+		bool empty() const noexcept { return size() == 0; }
+		IndexType index_type() const noexcept { return m_indexType; }
+		const void* data() const noexcept
+		{
+			return m_indexType == IndexType::UInt16 ? static_cast<const void*>(m_indices16.data()) : static_cast<const void*>(m_indices32.data());
+		}
+		size_t byte_size() const noexcept
+		{
+			return m_indexType == IndexType::UInt16 ? m_indices16.size() * sizeof(uint16_t) : m_indices32.size() * sizeof(uint32_t);
+		}
+	private:
+		void widen()
+		{
+			m_indices32.assign(m_indices16.begin(), m_indices16.end());
+			m_indices16.clear();
+			m_indexType = IndexType::UInt32;
+		}
+
+		std::vector<uint16_t> m_indices16;
+		std::vector<uint32_t> m_indices32;
+		IndexType m_indexType = IndexType::UInt16;
+	};
+}
+
+#endif
\ No newline at end of file
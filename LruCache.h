@@ -0,0 +1,125 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace clm {
+	struct LruStatistics {
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t evictions = 0;
+		size_t memorySize = 0;
+		size_t entryCount = 0;
+	};
+
+	// Least recently used cache with a memory budget in bytes. Each entry is charged the size given
+	// on insertion plus the cache's own bookkeeping for it. Pinned entries count towards the budget
+	// but are never evicted. Pointers returned by find() stay valid until the next insert().
+	template<typename Key, typename Value>
+	class LruCache {
+	public:
+		LruCache(const size_t budget = 0) noexcept : m_budget(budget) {}
+		~LruCache() = default;
+		LruCache(const LruCache&) = delete;
+		LruCache(LruCache&&) noexcept = default;
+		LruCache& operator=(const LruCache&) = delete;
+		LruCache& operator=(LruCache&&) noexcept = default;
+
+		bool contains(const Key& key) const noexcept
+		{
+			return m_index.contains(key);
+		}
+
+		// Marks the entry as most recently used, counts as a hit or a miss
+		Value* find(const Key& key) noexcept
+		{
+			const auto indexIter = m_index.find(key);
+			if (indexIter == m_index.end())
+			{
+				m_statistics.misses += 1;
+				return nullptr;
+			}
+			m_statistics.hits += 1;
+			m_entries.splice(m_entries.begin(), m_entries, indexIter->second);
+			return &indexIter->second->value;
+		}
+
+		// Inserts (or replaces) the entry as most recently used and evicts until the budget is met again.
+		// The new entry itself is never evicted, even if it doesn't fit on its own.
+		Value& insert(const Key& key, Value&& value, const size_t size, const bool pinned = false)
+		{
+			erase(key);
+			m_entries.push_front(Entry{key, std::move(value), size + s_entryOverhead, pinned});
+			m_index.emplace(key, m_entries.begin());
+			m_statistics.memorySize += m_entries.front().size;
+			m_statistics.entryCount += 1;
+			evict(1);
+			return m_entries.front().value;
+		}
+
+		void erase(const Key& key) noexcept
+		{
+			const auto indexIter = m_index.find(key);
+			if (indexIter == m_index.end())
+			{
+				return;
+			}
+			m_statistics.memorySize -= indexIter->second->size;
+			m_statistics.entryCount -= 1;
+			m_entries.erase(indexIter->second);
+			m_index.erase(indexIter);
+		}
+
+		void set_budget(const size_t budget) noexcept
+		{
+			m_budget = budget;
+			evict(0);
+		}
+
+		size_t budget() const noexcept { return m_budget; }
+		const LruStatistics& statistics() const noexcept { return m_statistics; }
+	private:
+		struct Entry {
+			Key key;
+			Value value;
+			size_t size;
+			bool pinned;
+		};
+		using entry_iter_t = typename std::list<Entry>::iterator;
+
+		// List node plus hash map node (with its share of the bucket array)
+		static constexpr size_t s_entryOverhead = sizeof(Entry) + 2 * sizeof(void*) +
+												  sizeof(std::pair<const Key, entry_iter_t>) + 2 * sizeof(void*);
+
+		// Evicts least recently used entries, except for the first keep entries
+		void evict(const size_t keep) noexcept
+		{
+			auto entryIter = m_entries.end();
+			size_t remaining = m_entries.size();
+			while (m_statistics.memorySize > m_budget && remaining > keep)
+			{
+				--entryIter;
+				remaining -= 1;
+				if (entryIter->pinned)
+				{
+					continue;
+				}
+				m_statistics.memorySize -= entryIter->size;
+				m_statistics.entryCount -= 1;
+				m_statistics.evictions += 1;
+				m_index.erase(entryIter->key);
+				entryIter = m_entries.erase(entryIter);
+			}
+		}
+
+		size_t m_budget;
+		std::list<Entry> m_entries;
+		std::unordered_map<Key, entry_iter_t> m_index;
+		LruStatistics m_statistics{};
+	};
+}
+
+#endif
\ No newline at end of file
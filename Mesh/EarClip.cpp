@@ -0,0 +1,353 @@
+#include "EarClip.h"
+
+#include <span>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace clm {
+	namespace {
+		// Circular list of the points left to clip
+		struct Node {
+			uint32_t point;
+			uint32_t prev;
+			uint32_t next;
+		};
+
+		double get_signed_area(std::span<const point_t> loop) noexcept
+		{
+			double area = 0.0;
+			for (size_t i = 0, j = loop.size() - 1; i < loop.size(); j = i++)
+			{
+				area += static_cast<double>(loop[j][0]) * loop[i][1] - static_cast<double>(loop[i][0]) * loop[j][1];
+			}
+			return 0.5 * area;
+		}
+
+		bool loop_contains(std::span<const point_t> loop, const point_t& point) noexcept
+		{
+			int32_t winding = 0;
+			for (size_t i = 0, j = loop.size() - 1; i < loop.size(); j = i++)
+			{
+				const point_t& p0 = loop[j];
+				const point_t& p1 = loop[i];
+				if (p0[1] <= point[1])
+				{
+					if (p1[1] > point[1] && orient2d(p0, p1, point) > 0.0)
+					{
+						winding++;
+					}
+				}
+				else if (p1[1] <= point[1] && orient2d(p0, p1, point) < 0.0)
+				{
+					winding--;
+				}
+			}
+			return winding != 0;
+		}
+
+		bool triangle_contains(const point_t& p0, const point_t& p1, const point_t& p2, const point_t& point) noexcept
+		{
+			return orient2d(p0, p1, point) >= 0.0 && orient2d(p1, p2, point) >= 0.0 && orient2d(p2, p0, point) >= 0.0;
+		}
+
+		bool is_same_point(const point_t& lhs, const point_t& rhs) noexcept
+		{
+			return lhs[0] == rhs[0] && lhs[1] == rhs[1];
+		}
+
+		class EarClipper {
+		public:
+			EarClipper(const std::vector<point_t>& points) noexcept
+				:
+				m_points(points)
+			{
+			}
+
+			uint32_t add_ring(const uint32_t first, const uint32_t count, const bool reversed)
+			{
+				const uint32_t firstNode = static_cast<uint32_t>(m_nodes.size());
+				for (uint32_t i = 0; i < count; i++)
+				{
+					const uint32_t point = reversed ? first + count - 1 - i : first + i;
+					m_nodes.push_back({point, firstNode + (i + count - 1) % count, firstNode + (i + 1) % count});
+				}
+				return firstNode;
+			}
+
+			// Connects the hole to the ring through its rightmost point, found by casting a ray
+			// towards +x to the closest ring edge (Eberly, "Triangulation by Ear Clipping")
+			bool bridge_hole(const uint32_t ring, const uint32_t hole)
+			{
+				uint32_t holeNode = hole;
+				for (uint32_t node = m_nodes[hole].next; node != hole; node = m_nodes[node].next)
+				{
+					if (get_point(node)[0] > get_point(holeNode)[0])
+					{
+						holeNode = node;
+					}
+				}
+				const point_t& m = get_point(holeNode);
+
+				std::optional<uint32_t> visibleNode{};
+				float closestX = std::numeric_limits<float>::max();
+				uint32_t node = ring;
+				do
+				{
+					const uint32_t next = m_nodes[node].next;
+					const point_t& p0 = get_point(node);
+					const point_t& p1 = get_point(next);
+					if ((p0[1] <= m[1] && m[1] < p1[1]) || (p1[1] <= m[1] && m[1] < p0[1]))
+					{
+						const float x = p0[0] + (m[1] - p0[1]) * (p1[0] - p0[0]) / (p1[1] - p0[1]);
+						if (x >= m[0] && x < closestX)
+						{
+							closestX = x;
+							visibleNode = p0[0] > p1[0] ? node : next;
+						}
+					}
+					node = next;
+				} while (node != ring);
+				if (!visibleNode)
+				{
+					return false;
+				}
+
+				// A reflex point inside the triangle between m, the hit and the edge's endpoint would
+				// hide the endpoint, the one closest in angle to the ray is visible instead
+				const point_t hit{closestX, m[1]};
+				const point_t candidate = get_point(*visibleNode);
+				float bestTangent = std::numeric_limits<float>::max();
+				node = ring;
+				do
+				{
+					const point_t& p = get_point(node);
+					if (node != *visibleNode && p[0] >= m[0] && !is_same_point(p, candidate) &&
+						orient2d(get_point(m_nodes[node].prev), p, get_point(m_nodes[node].next)) < 0.0 &&
+						(triangle_contains(m, hit, candidate, p) || triangle_contains(m, candidate, hit, p)))
+					{
+						const float tangent = std::abs(p[1] - m[1]) / std::max(p[0] - m[0], std::numeric_limits<float>::min());
+						if (tangent < bestTangent)
+						{
+							bestTangent = tangent;
+							visibleNode = node;
+						}
+					}
+					node = m_nodes[node].next;
+				} while (node != ring);
+
+				// Both ends of the bridge are duplicated, so the ring runs into the hole and back out
+				const uint32_t a = *visibleNode;
+				const uint32_t b = holeNode;
+				const uint32_t a2 = static_cast<uint32_t>(m_nodes.size());
+				const uint32_t b2 = a2 + 1;
+				const uint32_t aNext = m_nodes[a].next;
+				const uint32_t bPrev = m_nodes[b].prev;
+				m_nodes.push_back({m_nodes[a].point, b2, aNext});
+				m_nodes.push_back({m_nodes[b].point, bPrev, a2});
+				m_nodes[a].next = b;
+				m_nodes[b].prev = a;
+				m_nodes[aNext].prev = a2;
+				m_nodes[bPrev].next = b2;
+				return true;
+			}
+
+			bool clip(uint32_t node, uint32_t count, std::vector<uint32_t>& indices)
+			{
+				uint32_t stop = node;
+				while (count > 2)
+				{
+					const uint32_t prev = m_nodes[node].prev;
+					const uint32_t next = m_nodes[node].next;
+					const double orientation = orient2d(get_point(prev), get_point(node), get_point(next));
+					if (orientation == 0.0 || (orientation > 0.0 && is_ear(prev, node, next)))
+					{
+						// Collinear points (and spikes) are dropped without a triangle
+						if (orientation > 0.0)
+						{
+							indices.push_back(m_nodes[prev].point);
+							indices.push_back(m_nodes[node].point);
+							indices.push_back(m_nodes[next].point);
+						}
+						m_nodes[prev].next = next;
+						m_nodes[next].prev = prev;
+						count--;
+						node = next;
+						stop = next;
+						continue;
+					}
+					node = next;
+					if (node == stop)
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+		private:
+			const point_t& get_point(const uint32_t node) const noexcept
+			{
+				return m_points[m_nodes[node].point];
+			}
+
+			bool is_ear(const uint32_t prev, const uint32_t node, const uint32_t next) const noexcept
+			{
+				const point_t& p0 = get_point(prev);
+				const point_t& p1 = get_point(node);
+				const point_t& p2 = get_point(next);
+				for (uint32_t other = m_nodes[next].next; other != prev; other = m_nodes[other].next)
+				{
+					const point_t& p = get_point(other);
+					if (!is_same_point(p, p0) && !is_same_point(p, p1) && !is_same_point(p, p2) &&
+						triangle_contains(p0, p1, p2, p))
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+
+			const std::vector<point_t>& m_points;
+			std::vector<Node> m_nodes;
+		};
+	}
+
+	std::optional<std::vector<uint32_t>> ear_clip(const std::vector<std::vector<point_t>>& loops)
+	{
+		struct LoopInfo {
+			uint32_t first;
+			uint32_t count;
+			double area;
+		};
+		std::vector<point_t> points{};
+		std::vector<LoopInfo> loopInfos{};
+		loopInfos.reserve(loops.size());
+		double largestArea = 0.0;
+		for (const std::vector<point_t>& loop : loops)
+		{
+			const double area = loop.size() < 3 ? 0.0 : get_signed_area(loop);
+			loopInfos.push_back({static_cast<uint32_t>(points.size()), static_cast<uint32_t>(loop.size()), area});
+			points.insert(points.end(), loop.begin(), loop.end());
+			if (std::abs(area) > std::abs(largestArea))
+			{
+				largestArea = area;
+			}
+		}
+		std::vector<uint32_t> indices{};
+		if (largestArea == 0.0)
+		{
+			// Nothing to fill, unless a loop crosses itself so that its parts cancel out (e.g. a bowtie)
+			const bool hasPolygon = std::any_of(loops.begin(),
+												loops.end(),
+												[](const std::vector<point_t>& loop)
+												{
+													for (size_t i = 0; loop.size() >= 3 && i < loop.size(); i++)
+													{
+														if (orient2d(loop[i], loop[(i + 1) % loop.size()], loop[(i + 2) % loop.size()]) != 0.0)
+														{
+															return true;
+														}
+													}
+													return false;
+												});
+			if (hasPolygon)
+			{
+				return {};
+			}
+			return {indices};
+		}
+
+		// Outlines are made counterclockwise and holes clockwise
+		const bool reversed = largestArea < 0.0;
+		std::vector<size_t> outlines{};
+		std::vector<std::vector<size_t>> outlineHoles(loops.size());
+		for (size_t i = 0; i < loopInfos.size(); i++)
+		{
+			if (loopInfos[i].area != 0.0 && (loopInfos[i].area < 0.0) == reversed)
+			{
+				outlines.push_back(i);
+			}
+		}
+		for (size_t i = 0; i < loopInfos.size(); i++)
+		{
+			if (loopInfos[i].area == 0.0 || (loopInfos[i].area < 0.0) == reversed)
+			{
+				continue;
+			}
+			std::optional<size_t> container{};
+			for (const size_t outline : outlines)
+			{
+				if ((!container || std::abs(loopInfos[outline].area) < std::abs(loopInfos[*container].area)) &&
+					loop_contains(loops[outline], loops[i][0]))
+				{
+					container = outline;
+				}
+			}
+			if (!container)
+			{
+				return {};
+			}
+			outlineHoles[*container].push_back(i);
+		}
+
+		EarClipper clipper{points};
+		indices.reserve(3 * points.size());
+		for (const size_t outline : outlines)
+		{
+			const uint32_t ring = clipper.add_ring(loopInfos[outline].first, loopInfos[outline].count, reversed);
+			uint32_t count = loopInfos[outline].count;
+
+			// Holes reaching furthest right are bridged first, so later bridges can't cross them
+			std::vector<size_t>& holes = outlineHoles[outline];
+			const auto get_max_x = [&loops](const size_t loop)
+			{
+				return (*std::max_element(loops[loop].begin(),
+										  loops[loop].end(),
+										  [](const point_t& lhs, const point_t& rhs)
+										  {
+											  return lhs[0] < rhs[0];
+										  }))[0];
+			};
+			std::sort(holes.begin(),
+					  holes.end(),
+					  [&get_max_x](const size_t lhs, const size_t rhs)
+					  {
+						  return get_max_x(lhs) > get_max_x(rhs);
+					  });
+			for (const size_t hole : holes)
+			{
+				const uint32_t holeRing = clipper.add_ring(loopInfos[hole].first, loopInfos[hole].count, reversed);
+				if (!clipper.bridge_hole(ring, holeRing))
+				{
+					return {};
+				}
+				count += loopInfos[hole].count + 2;
+			}
+
+			if (!clipper.clip(ring, count, indices))
+			{
+				return {};
+			}
+		}
+
+		// Crossing loops can still clip "successfully" into overlapping triangles, which shows up
+		// as more triangle area than the loops enclose
+		double loopArea = 0.0;
+		for (const LoopInfo& loopInfo : loopInfos)
+		{
+			loopArea += loopInfo.area;
+		}
+		double triangleArea = 0.0;
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			triangleArea += 0.5 * orient2d(points[indices[i]], points[indices[i + 1]], points[indices[i + 2]]);
+		}
+		constexpr double areaTolerance = 1e-4;
+		if (std::abs(triangleArea - std::abs(loopArea)) > areaTolerance * std::abs(loopArea))
+		{
+			return {};
+		}
+
+		return {indices};
+	}
+}
\ No newline at end of file
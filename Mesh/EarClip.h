@@ -0,0 +1,20 @@
+#ifndef EAR_CLIP_H
+#define EAR_CLIP_H
+
+#include <vector>
+#include <optional>
+#include <cstdint>
+
+#include "MeshUtil.h"
+
+namespace clm {
+	// Triangulates closed loops by ear clipping. Loops wound like the largest one are outlines, the
+	// others are holes and get bridged into the smallest outline around them. Then convex corners
+	// with no other point in their triangle are clipped off one at a time. Everything works on
+	// linked arrays of the loop points, with no hashing, but it takes O(n^2) time, so it only pays off
+	// for small outlines. Indices refer to the points of all loops one after another. Loops that
+	// can't be clipped (e.g. ones that cross each other) give no result.
+	std::optional<std::vector<uint32_t>> ear_clip(const std::vector<std::vector<point_t>>&);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,173 @@
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+#include <vector>
+#include <utility>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace clm {
+	// Open addressing hash map from 64 bit keys (e.g. two packed 32 bit point indices) to small
+	// values. Slots live in a single array that is at most half full, collisions are resolved by
+	// linear probing and erase() shifts the following entries back instead of leaving tombstones, so
+	// probe sequences stay short however many entries come and go. Only growing allocates, and
+	// clear() keeps the slots. The all ones key marks empty slots and can't be stored.
+	template<typename Value>
+	class FlatHashMap {
+	public:
+		using key_t = uint64_t;
+
+		FlatHashMap() noexcept = default;
+		~FlatHashMap() = default;
+		FlatHashMap(const FlatHashMap&) = default;
+		FlatHashMap(FlatHashMap&&) noexcept = default;
+		FlatHashMap& operator=(const FlatHashMap&) = default;
+		FlatHashMap& operator=(FlatHashMap&&) noexcept = default;
+
+		void reserve(const size_t count)
+		{
+			size_t capacity = s_minCapacity;
+			while (capacity < 2 * count)
+			{
+				capacity *= 2;
+			}
+			if (capacity > m_slots.size())
+			{
+				rehash(capacity);
+			}
+		}
+
+		// Inserts a default constructed value if the key isn't there yet
+		Value& operator[](const key_t key)
+		{
+			if (2 * (m_size + 1) > m_slots.size())
+			{
+				rehash(m_slots.empty() ? s_minCapacity : 2 * m_slots.size());
+			}
+			size_t slot = get_home_slot(key);
+			while (m_slots[slot].key != s_emptyKey)
+			{
+				if (m_slots[slot].key == key)
+				{
+					return m_slots[slot].value;
+				}
+				slot = (slot + 1) & (m_slots.size() - 1);
+			}
+			m_slots[slot] = Slot{key, Value{}};
+			m_size++;
+			return m_slots[slot].value;
+		}
+
+		void insert_or_assign(const key_t key, const Value& value)
+		{
+			(*this)[key] = value;
+		}
+
+		const Value* find(const key_t key) const noexcept
+		{
+			if (m_size == 0)
+			{
+				return nullptr;
+			}
+			for (size_t slot = get_home_slot(key); m_slots[slot].key != s_emptyKey; slot = (slot + 1) & (m_slots.size() - 1))
+			{
+				if (m_slots[slot].key == key)
+				{
+					return &m_slots[slot].value;
+				}
+			}
+			return nullptr;
+		}
+
+		bool contains(const key_t key) const noexcept
+		{
+			return find(key) != nullptr;
+		}
+
+		bool erase(const key_t key) noexcept
+		{
+			if (m_size == 0)
+			{
+				return false;
+			}
+			const size_t mask = m_slots.size() - 1;
+			size_t slot = get_home_slot(key);
+			while (m_slots[slot].key != key)
+			{
+				if (m_slots[slot].key == s_emptyKey)
+				{
+					return false;
+				}
+				slot = (slot + 1) & mask;
+			}
+
+			// Move later entries of the cluster into the hole unless that would put them before
+			// their home slot
+			size_t hole = slot;
+			for (size_t next = (hole + 1) & mask; m_slots[next].key != s_emptyKey; next = (next + 1) & mask)
+			{
+				const size_t home = get_home_slot(m_slots[next].key);
+				if (((next - home) & mask) >= ((next - hole) & mask))
+				{
+					m_slots[hole] = std::move(m_slots[next]);
+					hole = next;
+				}
+			}
+			m_slots[hole].key = s_emptyKey;
+			m_size--;
+			return true;
+		}
+
+		void clear() noexcept
+		{
+			for (Slot& slot : m_slots)
+			{
+				slot.key = s_emptyKey;
+			}
+			m_size = 0;
+		}
+
+		size_t size() const noexcept { return m_size; }
+		bool empty() const noexcept { return m_size == 0; }
+	private:
+		static constexpr key_t s_emptyKey = ~key_t{0};
+		static constexpr size_t s_minCapacity = 16;
+
+		struct Slot {
+			key_t key = s_emptyKey;
+			Value value{};
+		};
+
+		size_t get_home_slot(const key_t key) const noexcept
+		{
+			// Fibonacci hashing, the high bits of the product depend on every bit of the key
+			return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> m_shift);
+		}
+
+		void rehash(const size_t capacity)
+		{
+			std::vector<Slot> slots(capacity);
+			std::swap(slots, m_slots);
+			m_shift = 64 - static_cast<uint32_t>(std::countr_zero(capacity));
+			const size_t mask = capacity - 1;
+			for (Slot& slot : slots)
+			{
+				if (slot.key != s_emptyKey)
+				{
+					size_t newSlot = get_home_slot(slot.key);
+					while (m_slots[newSlot].key != s_emptyKey)
+					{
+						newSlot = (newSlot + 1) & mask;
+					}
+					m_slots[newSlot] = std::move(slot);
+				}
+			}
+		}
+
+		std::vector<Slot> m_slots;
+		size_t m_size = 0;
+		uint32_t m_shift = 64;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <format>
 #include <string>
+#include <algorithm>
 
 #include "Mesh.h"
 
@@ -19,17 +20,39 @@ namespace clm {
 	std::vector<triangle_t> Mesh::get_triangles() const noexcept
 	{
 		std::vector<triangle_t> triangles{};
-		triangles.reserve(m_triangles.size());
-		for (const auto& triangle : m_triangles)
+		triangles.reserve(m_triangleVertices.size());
+		for (const std::array<uint32_t, 3>& vertices : m_triangleVertices)
 		{
-			if (!triangle.deleted)
+			if (vertices[0] != s_noIndex)
 			{
-				triangles.push_back(triangle.triangle);
+				triangles.emplace_back(vertices[0], vertices[1], vertices[2]);
 			}
 		}
 
 		return triangles;
 	}
+
+	std::span<const std::array<uint32_t, 3>> Mesh::get_triangle_view() const noexcept(util::release)
+	{
+		err::assert<std::runtime_error>(m_freeTriangles.empty(), "Triangle view of a mesh with deleted triangles");
+		return m_triangleVertices;
+	}
+
+	size_t Mesh::get_triangle_slot_count() const noexcept
+	{
+		return m_triangleVertices.size();
+	}
+
+	bool Mesh::is_triangle_deleted(const size_t triangleIndex) const noexcept
+	{
+		return m_triangleVertices[triangleIndex][0] == s_noIndex;
+	}
+
+	std::array<size_t, 3> Mesh::get_triangle_points(const size_t triangleIndex) const noexcept
+	{
+		const std::array<uint32_t, 3>& vertices = m_triangleVertices[triangleIndex];
+		return {vertices[0], vertices[1], vertices[2]};
+	}
 #else
 	const std::unordered_map<const triangle_t*, Mesh::triangle_ptr_t>& Mesh::get_triangles() const noexcept
 	{
@@ -37,6 +60,215 @@ namespace clm {
 	}
 #endif
 
+#if USE_TRIANGLE_VECTOR && USE_TRIANGLE_NEIGHBORS
+	std::optional<size_t> Mesh::get_neighbor(const size_t triangleIndex, const size_t edge) const noexcept
+	{
+		const uint32_t neighbor = m_triangleNeighbors[triangleIndex][edge];
+		if (neighbor == s_noIndex)
+		{
+			return {};
+		}
+		return {neighbor};
+	}
+
+	std::optional<size_t> Mesh::get_edge_triangle(const size_t p0, const size_t p1) const noexcept
+	{
+		if (p0 >= m_pointTriangles.size() || m_pointTriangles[p0] == s_noIndex)
+		{
+			return {};
+		}
+
+		// Turn around p0 through the neighbors, first clockwise (across the edge into p0) and, if
+		// that runs into the border, counterclockwise from the start. Every triangle after the start
+		// shares an edge into p0, so only the start has to be checked for p0.
+		const uint32_t start = m_pointTriangles[p0];
+		const std::array<uint32_t, 3>& startVertices = m_triangleVertices[start];
+		if (std::find(startVertices.begin(), startVertices.end(), p0) == startVertices.end())
+		{
+			return {};
+		}
+		uint32_t triangleIndex = start;
+		do
+		{
+			const std::array<uint32_t, 3>& vertices = m_triangleVertices[triangleIndex];
+			const size_t corner = vertices[0] == p0 ? 0 : (vertices[1] == p0 ? 1 : 2);
+			if (vertices[(corner + 1) % 3] == p1)
+			{
+				return {triangleIndex};
+			}
+			triangleIndex = m_triangleNeighbors[triangleIndex][(corner + 2) % 3];
+		} while (triangleIndex != s_noIndex && triangleIndex != start);
+		if (triangleIndex == start)
+		{
+			return {};
+		}
+
+		triangleIndex = start;
+		while (true)
+		{
+			const std::array<uint32_t, 3>& vertices = m_triangleVertices[triangleIndex];
+			const size_t corner = vertices[0] == p0 ? 0 : (vertices[1] == p0 ? 1 : 2);
+			triangleIndex = m_triangleNeighbors[triangleIndex][corner];
+			if (triangleIndex == s_noIndex || triangleIndex == start)
+			{
+				return {};
+			}
+			const std::array<uint32_t, 3>& nextVertices = m_triangleVertices[triangleIndex];
+			const size_t nextCorner = nextVertices[0] == p0 ? 0 : (nextVertices[1] == p0 ? 1 : 2);
+			if (nextVertices[(nextCorner + 1) % 3] == p1)
+			{
+				return {triangleIndex};
+			}
+		}
+	}
+
+	void Mesh::delete_triangle_at(const size_t triangleIndex)
+	{
+		const std::array<uint32_t, 3> vertices = m_triangleVertices[triangleIndex];
+		for (size_t edge = 0; edge < 3; edge++)
+		{
+			// The neighbor's edge becomes open, so the triangle that fills the gap can link to it
+			const uint32_t neighbor = m_triangleNeighbors[triangleIndex][edge];
+			if (neighbor != s_noIndex)
+			{
+				std::array<uint32_t, 3>& neighborNeighbors = m_triangleNeighbors[neighbor];
+				const size_t neighborEdge = neighborNeighbors[0] == triangleIndex ? 0 : (neighborNeighbors[1] == triangleIndex ? 1 : 2);
+				neighborNeighbors[neighborEdge] = s_noIndex;
+				m_openEdges.emplace_back(neighbor, static_cast<uint32_t>(neighborEdge));
+			}
+		}
+		for (size_t corner = 0; corner < 3; corner++)
+		{
+			// Any other triangle around the point will do, the neighbors are the only ones at hand.
+			// Lookups only need it while the triangles around the point form a single fan.
+			uint32_t& pointTriangle = m_pointTriangles[vertices[corner]];
+			if (pointTriangle == triangleIndex)
+			{
+				const uint32_t before = m_triangleNeighbors[triangleIndex][(corner + 2) % 3];
+				const uint32_t after = m_triangleNeighbors[triangleIndex][corner];
+				if (before != s_noIndex)
+				{
+					pointTriangle = before;
+				}
+				else if (after != s_noIndex)
+				{
+					pointTriangle = after;
+				}
+				else
+				{
+					// Never left pointing at the deleted slot, which may be reused without the point
+					pointTriangle = s_noIndex;
+				}
+			}
+		}
+		m_triangleVertices[triangleIndex] = {s_noIndex, s_noIndex, s_noIndex};
+		m_triangleNeighbors[triangleIndex] = {s_noIndex, s_noIndex, s_noIndex};
+		m_freeTriangles.push_back(static_cast<uint32_t>(triangleIndex));
+	}
+
+	void Mesh::reserve_triangles(const size_t count)
+	{
+		m_triangleVertices.reserve(count);
+		m_triangleNeighbors.reserve(count);
+		m_pointTriangles.reserve(m_points.size());
+	}
+
+	void Mesh::compact_triangles()
+	{
+		std::vector<uint32_t> newIndices(m_triangleVertices.size(), s_noIndex);
+		uint32_t count = 0;
+		for (size_t i = 0; i < m_triangleVertices.size(); i++)
+		{
+			if (m_triangleVertices[i][0] != s_noIndex)
+			{
+				newIndices[i] = count;
+				m_triangleVertices[count] = m_triangleVertices[i];
+				m_triangleNeighbors[count] = m_triangleNeighbors[i];
+				count++;
+			}
+		}
+		m_triangleVertices.resize(count);
+		m_triangleNeighbors.resize(count);
+		m_freeTriangles.clear();
+
+		// Neighbors and point triangles are always live triangles, the open edges are found again
+		m_openEdges.clear();
+		for (uint32_t triangleIndex = 0; triangleIndex < count; triangleIndex++)
+		{
+			for (uint32_t edge = 0; edge < 3; edge++)
+			{
+				uint32_t& neighbor = m_triangleNeighbors[triangleIndex][edge];
+				if (neighbor == s_noIndex)
+				{
+					m_openEdges.emplace_back(triangleIndex, edge);
+				}
+				else
+				{
+					neighbor = newIndices[neighbor];
+				}
+			}
+		}
+		for (uint32_t& pointTriangle : m_pointTriangles)
+		{
+			if (pointTriangle != s_noIndex)
+			{
+				pointTriangle = newIndices[pointTriangle];
+			}
+		}
+	}
+#elif USE_TRIANGLE_VECTOR
+	std::optional<size_t> Mesh::get_neighbor(const size_t triangleIndex, const size_t edge) const noexcept
+	{
+		const std::array<uint32_t, 3>& vertices = m_triangleVertices[triangleIndex];
+		return get_edge_triangle(vertices[(edge + 1) % 3], vertices[edge]);
+	}
+
+	std::optional<size_t> Mesh::get_edge_triangle(const size_t p0, const size_t p1) const noexcept
+	{
+		if (const size_t* triangleIndex = m_edgeTriangleMap.find(get_edge_key(p0, p1)))
+		{
+			return {*triangleIndex};
+		}
+		return {};
+	}
+
+	void Mesh::delete_triangle_at(const size_t triangleIndex)
+	{
+		const std::array<uint32_t, 3> vertices = m_triangleVertices[triangleIndex];
+		m_edgeTriangleMap.erase(get_edge_key(vertices[0], vertices[1]));
+		m_edgeTriangleMap.erase(get_edge_key(vertices[1], vertices[2]));
+		m_edgeTriangleMap.erase(get_edge_key(vertices[2], vertices[0]));
+
+		m_triangleVertices[triangleIndex] = {s_noIndex, s_noIndex, s_noIndex};
+		m_freeTriangles.push_back(static_cast<uint32_t>(triangleIndex));
+	}
+
+	void Mesh::reserve_triangles(const size_t count)
+	{
+		m_triangleVertices.reserve(count);
+		m_edgeTriangleMap.reserve(3 * count);
+	}
+
+	void Mesh::compact_triangles()
+	{
+		std::erase_if(m_triangleVertices,
+					  [](const std::array<uint32_t, 3>& vertices)
+					  {
+						  return vertices[0] == s_noIndex;
+					  });
+		m_freeTriangles.clear();
+
+		m_edgeTriangleMap.clear();
+		for (size_t triangleIndex = 0; triangleIndex < m_triangleVertices.size(); triangleIndex++)
+		{
+			const std::array<uint32_t, 3>& vertices = m_triangleVertices[triangleIndex];
+			m_edgeTriangleMap.insert_or_assign(get_edge_key(vertices[0], vertices[1]), triangleIndex);
+			m_edgeTriangleMap.insert_or_assign(get_edge_key(vertices[1], vertices[2]), triangleIndex);
+			m_edgeTriangleMap.insert_or_assign(get_edge_key(vertices[2], vertices[0]), triangleIndex);
+		}
+	}
+#endif
+
 	void Mesh::add_points(const std::vector<point_t>& points)
 	{
 		m_points.reserve(m_points.size() + points.size());
@@ -51,33 +283,82 @@ namespace clm {
 		m_points.push_back(point);
 	}
 
+#if USE_TRIANGLE_VECTOR
+	size_t Mesh::add_triangle(const size_t p0, const size_t p1, const size_t p2)
+#else
 	void Mesh::add_triangle(const size_t p0, const size_t p1, const size_t p2)
+#endif
 	{
 #if USE_TRIANGLE_VECTOR
-		size_t newTriangleIndex{};
-		if (m_openIndices.empty())
+		const std::array<uint32_t, 3> vertices{static_cast<uint32_t>(p0), static_cast<uint32_t>(p1), static_cast<uint32_t>(p2)};
+		uint32_t newTriangleIndex{};
+		if (m_freeTriangles.empty())
 		{
-			m_triangles.emplace_back(false, triangle_t{p0, p1, p2});
-			newTriangleIndex = m_triangles.size() - 1;
+			newTriangleIndex = static_cast<uint32_t>(m_triangleVertices.size());
+			m_triangleVertices.push_back(vertices);
+#if USE_TRIANGLE_NEIGHBORS
+			m_triangleNeighbors.push_back({s_noIndex, s_noIndex, s_noIndex});
+#endif
 		}
 		else
 		{
-			newTriangleIndex = m_openIndices.front();
-			m_openIndices.pop();
-			if (!m_triangles[newTriangleIndex].deleted)
+			newTriangleIndex = m_freeTriangles.back();
+			m_freeTriangles.pop_back();
+			m_triangleVertices[newTriangleIndex] = vertices;
+		}
+
+#if USE_TRIANGLE_NEIGHBORS
+		// Each edge either closes an open edge in the opposite direction or becomes open itself.
+		// Entries of edges that got a neighbor or lost their triangle in the meantime are dropped
+		// on the way.
+		for (uint32_t edge = 0; edge < 3; edge++)
+		{
+			const uint32_t start = vertices[edge];
+			const uint32_t end = vertices[(edge + 1) % 3];
+			bool linked = false;
+			for (size_t i = 0; i < m_openEdges.size() && !linked;)
 			{
-				throw std::runtime_error{"Attempting to overwrite active triangle"};
+				const auto [openTriangle, openEdge] = m_openEdges[i];
+				const std::array<uint32_t, 3>& openVertices = m_triangleVertices[openTriangle];
+				if (openVertices[0] == s_noIndex || m_triangleNeighbors[openTriangle][openEdge] != s_noIndex)
+				{
+					m_openEdges[i] = m_openEdges.back();
+					m_openEdges.pop_back();
+					continue;
+				}
+				if (openVertices[openEdge] == end && openVertices[(openEdge + 1) % 3] == start)
+				{
+					m_triangleNeighbors[newTriangleIndex][edge] = openTriangle;
+					m_triangleNeighbors[openTriangle][openEdge] = newTriangleIndex;
+					m_openEdges[i] = m_openEdges.back();
+					m_openEdges.pop_back();
+					linked = true;
+					continue;
+				}
+				i++;
+			}
+			if (!linked)
+			{
+				m_openEdges.emplace_back(newTriangleIndex, edge);
 			}
-			m_triangles[newTriangleIndex] = TriangleInfo(false, triangle_t{p0, p1, p2});
 		}
 
-		m_pointTriangleMap[{p0, p1, p2}] = newTriangleIndex;
-		m_pointTriangleMap[{p1, p2, p0}] = newTriangleIndex;
-		m_pointTriangleMap[{p2, p0, p1}] = newTriangleIndex;
+		const size_t maxPoint = std::max({p0, p1, p2});
+		if (maxPoint >= m_pointTriangles.size())
+		{
+			m_pointTriangles.resize(std::max(maxPoint + 1, m_points.size()), s_noIndex);
+		}
+		for (const uint32_t vertex : vertices)
+		{
+			m_pointTriangles[vertex] = newTriangleIndex;
+		}
+#else
+		m_edgeTriangleMap.insert_or_assign(get_edge_key(p0, p1), newTriangleIndex);
+		m_edgeTriangleMap.insert_or_assign(get_edge_key(p1, p2), newTriangleIndex);
+		m_edgeTriangleMap.insert_or_assign(get_edge_key(p2, p0), newTriangleIndex);
+#endif
 
-		m_edgeTriangleMap[{p0, p1}] = newTriangleIndex;
-		m_edgeTriangleMap[{p1, p2}] = newTriangleIndex;
-		m_edgeTriangleMap[{p2, p0}] = newTriangleIndex;
+		return newTriangleIndex;
 #else
 		if (m_pointTriangleMap.contains({p0, p1, p2}))
 		{
@@ -168,21 +449,13 @@ namespace clm {
 	void Mesh::delete_triangle(size_t p0, size_t p1, size_t p2)
 	{
 #if USE_TRIANGLE_VECTOR
-		const auto indexIterator = m_pointTriangleMap.find({p0, p1, p2});
-		if (indexIterator == m_pointTriangleMap.end())
+		// The edge p0 -> p1 identifies the triangle, p1 -> p2 has to belong to the same one
+		const std::optional<size_t> triangleIndex = get_edge_triangle(p0, p1);
+		if (!triangleIndex || get_edge_triangle(p1, p2) != triangleIndex)
 		{
 			return;
 		}
-		m_triangles[indexIterator->second].deleted = true;
-		m_openIndices.push(indexIterator->second);
-
-		m_pointTriangleMap.erase({p0, p1, p2});
-		m_pointTriangleMap.erase({p1, p2, p0});
-		m_pointTriangleMap.erase({p2, p0, p1});
-
-		m_edgeTriangleMap.erase({p0, p1});
-		m_edgeTriangleMap.erase({p1, p2});
-		m_edgeTriangleMap.erase({p2, p0});
+		delete_triangle_at(*triangleIndex);
 #else
 		err::assert<std::runtime_error>(m_pointTriangleMap.find({p0, p1, p2}) != m_pointTriangleMap.end() &&
 										m_pointTriangleMap.find({p1, p2, p0}) != m_pointTriangleMap.end() &&
@@ -6,14 +6,23 @@
 #include <unordered_map>
 #include <tuple>
 #include <optional>
-#include <queue>
+#include <array>
+#include <limits>
+#include <span>
 
 #include "Point.h"
 #include "Triangle.h"
 #include "Edge.h"
 #include "MeshUtil.h"
+#include "FlatHashMap.h"
 
 #define USE_TRIANGLE_VECTOR 1
+// Together with USE_TRIANGLE_VECTOR: triangles are flat arrays of their vertices and of the neighbor
+// across each edge, so adjacency is an array lookup instead of a hash map lookup. Can be set to 0 by
+// the build to compare both (see Benchmarks/MeshAdjacency.cpp).
+#ifndef USE_TRIANGLE_NEIGHBORS
+#define USE_TRIANGLE_NEIGHBORS 1
+#endif
 
 namespace clm {
 	class Mesh {
@@ -38,31 +47,66 @@ namespace clm {
 
 #if USE_TRIANGLE_VECTOR
 		std::vector<triangle_t> get_triangles() const noexcept;
+		// Point indices of the triangles in place, valid until the mesh changes. Only available
+		// once compact_triangles() has removed the deleted ones.
+		std::span<const std::array<uint32_t, 3>> get_triangle_view() const noexcept(util::release);
 #else
 		const std::unordered_map<const triangle_t*, triangle_ptr_t>& get_triangles() const noexcept;
 #endif
 
 		void add_points(const std::vector<point_t>&);
 		void add_point(const point_t&);
+#if USE_TRIANGLE_VECTOR
+		// Returns the index of the new triangle
+		size_t add_triangle(size_t, size_t, size_t);
+#else
 		void add_triangle(size_t, size_t, size_t);
+#endif
 		void delete_triangle(size_t, size_t, size_t);
 	protected:
 		void add_triangle_impl(const point_t*, const point_t*, const point_t*);
 		void delete_triangle_impl(const point_t*, const point_t*, const point_t*);
 		std::optional<const point_t*> get_adjacent_impl(const point_t*, const point_t*) const noexcept(util::release);
+#if USE_TRIANGLE_VECTOR
+		// Triangles by index. Indices of deleted triangles are reused, get_triangle_slot_count() is
+		// one past the largest index in use.
+		size_t get_triangle_slot_count() const noexcept;
+		bool is_triangle_deleted(size_t) const noexcept;
+		std::array<size_t, 3> get_triangle_points(size_t) const noexcept;
+		// The triangle across the edge from point i to point i + 1 of the triangle
+		std::optional<size_t> get_neighbor(size_t, size_t) const noexcept;
+		// The triangle that has the directed edge p0 -> p1
+		std::optional<size_t> get_edge_triangle(size_t, size_t) const noexcept;
+		void delete_triangle_at(size_t);
+		void reserve_triangles(size_t);
+		// Moves the remaining triangles to the front, so indices change
+		void compact_triangles();
+
+		// Point indices are packed into 32 bits each
+		static uint64_t get_edge_key(const size_t p0, const size_t p1) noexcept
+		{
+			return (static_cast<uint64_t>(p0) << 32) | static_cast<uint64_t>(p1);
+		}
+#endif
 
 		std::vector<point_t> m_points;
 #if USE_TRIANGLE_VECTOR
-		struct TriangleInfo {
-			bool deleted;
-			triangle_t triangle;
-		};
-
-		std::vector<TriangleInfo> m_triangles;
-		std::queue<size_t> m_openIndices;
+		static constexpr uint32_t s_noIndex = std::numeric_limits<uint32_t>::max();
 
-		std::unordered_map<point_triangle_key_t, size_t, tuple_hash> m_pointTriangleMap;
-		std::unordered_map<edge_triangle_key_t, size_t, tuple_hash> m_edgeTriangleMap;
+		// Deleted triangles have s_noIndex as their first vertex
+		std::vector<std::array<uint32_t, 3>> m_triangleVertices;
+		std::vector<uint32_t> m_freeTriangles;
+#if USE_TRIANGLE_NEIGHBORS
+		std::vector<std::array<uint32_t, 3>> m_triangleNeighbors;
+		// A triangle around every point, where edge searches start
+		std::vector<uint32_t> m_pointTriangles;
+		// Edges (triangle, edge) without a neighbor yet. New triangles are linked to these, and they
+		// only pile up along the border of the mesh and of holes that are about to be filled.
+		std::vector<std::pair<uint32_t, uint32_t>> m_openEdges;
+#else
+		// Every directed edge belongs to exactly one triangle, which also identifies the triangle
+		FlatHashMap<size_t> m_edgeTriangleMap;
+#endif
 #else
 		std::unordered_map<const edge_t*, edge_ptr_t> m_edges;
 		std::unordered_map<const triangle_t*, triangle_ptr_t> m_triangles;
@@ -7,6 +7,8 @@
 #include <clmMath/clm_vector.h>
 #include <clmMath/clm_matrix.h>
 
+#include "Predicates.h"
+
 namespace clm {
 	class Edge;
 	class Triangle;
@@ -37,8 +39,8 @@ namespace clm {
 									const point_t& p2,
 									const point_t& p3)
 	{
-		const float crossProduct = cross_product(p1, p2, p3);
-		return (crossProduct >= 0.0f) || std::isnan(crossProduct);
+		const double orientation = orient2d(p1, p2, p3);
+		return (orientation >= 0.0) || std::isnan(orientation);
 	}
 
 
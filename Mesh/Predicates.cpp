@@ -0,0 +1,218 @@
+#include "Predicates.h"
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+namespace clm {
+	namespace {
+		constexpr double epsilon = std::numeric_limits<double>::epsilon() / 2.0;
+		// Error bounds of the double precision evaluations
+		constexpr double orientErrorBound = (3.0 + 16.0 * epsilon) * epsilon;
+		constexpr double incircleErrorBound = (10.0 + 96.0 * epsilon) * epsilon;
+
+		std::atomic<uint64_t> g_orientCalls = 0;
+		std::atomic<uint64_t> g_orientExact = 0;
+		std::atomic<uint64_t> g_incircleCalls = 0;
+		std::atomic<uint64_t> g_incircleExact = 0;
+
+		constexpr uint32_t callBatchSize = 4096;
+		thread_local uint32_t t_orientCalls = 0;
+		thread_local uint32_t t_incircleCalls = 0;
+
+		void count_call(uint32_t& calls, std::atomic<uint64_t>& total) noexcept
+		{
+			[[unlikely]] if (++calls == callBatchSize)
+			{
+				total.fetch_add(callBatchSize, std::memory_order_relaxed);
+				calls = 0;
+			}
+		}
+
+		// Floating-point expansion: a sum of doubles that don't overlap, in order of increasing
+		// magnitude, so its sign is the sign of the last (largest) component
+		template<size_t capacity>
+		class Expansion {
+		public:
+			// Exact a * b, where a and b are products of two floats and therefore exact themselves
+			void add_product(const double a, const double b) noexcept
+			{
+				const double product = a * b;
+				add(std::fma(a, b, -product));
+				add(product);
+			}
+			void add(const double value) noexcept
+			{
+				// Grow-Expansion with zero elimination
+				double q = value;
+				size_t count = 0;
+				for (size_t i = 0; i < m_size; i++)
+				{
+					const double sum = q + m_components[i];
+					const double bVirtual = sum - q;
+					const double aVirtual = sum - bVirtual;
+					const double error = (q - aVirtual) + (m_components[i] - bVirtual);
+					q = sum;
+					if (error != 0.0)
+					{
+						m_components[count++] = error;
+					}
+				}
+				if (q != 0.0)
+				{
+					m_components[count++] = q;
+				}
+				m_size = count;
+			}
+			double estimate() const noexcept
+			{
+				return m_size == 0 ? 0.0 : m_components[m_size - 1];
+			}
+		private:
+			std::array<double, capacity> m_components{};
+			size_t m_size = 0;
+		};
+
+		double orient2d_exact(const double ax, const double ay,
+							  const double bx, const double by,
+							  const double cx, const double cy) noexcept
+		{
+			// ax * by - ax * cy - ay * bx + ay * cx + bx * cy - by * cx, every product is exact
+			Expansion<8> expansion{};
+			expansion.add(ax * by);
+			expansion.add(-ax * cy);
+			expansion.add(-ay * bx);
+			expansion.add(ay * cx);
+			expansion.add(bx * cy);
+			expansion.add(-by * cx);
+			return expansion.estimate();
+		}
+
+		double incircle_exact(const math::Point2f& a, const math::Point2f& b, const math::Point2f& c, const math::Point2f& d) noexcept
+		{
+			// Determinant of the rows (x, y, x^2 + y^2, 1), expanded along the lifted column:
+			// lift(a) * orient(b, c, d) - lift(b) * orient(a, c, d) + lift(c) * orient(a, b, d) - lift(d) * orient(a, b, c)
+			const std::array<const math::Point2f*, 4> points{&a, &b, &c, &d};
+			Expansion<112> expansion{};
+			for (size_t i = 0; i < 4; i++)
+			{
+				std::array<const math::Point2f*, 3> others{};
+				for (size_t j = 0, k = 0; j < 4; j++)
+				{
+					if (j != i)
+					{
+						others[k++] = points[j];
+					}
+				}
+				const double sign = i % 2 == 0 ? 1.0 : -1.0;
+				const double px = (*others[0])[0], py = (*others[0])[1];
+				const double qx = (*others[1])[0], qy = (*others[1])[1];
+				const double rx = (*others[2])[0], ry = (*others[2])[1];
+				const std::array<double, 6> orientTerms{px * qy, -px * ry, -py * qx, py * rx, qx * ry, -qy * rx};
+				const double x = (*points[i])[0];
+				const double y = (*points[i])[1];
+				for (const double term : orientTerms)
+				{
+					expansion.add_product(sign * x * x, term);
+					expansion.add_product(sign * y * y, term);
+				}
+			}
+			return expansion.estimate();
+		}
+	}
+
+	double orient2d(const math::Point2f& a, const math::Point2f& b, const math::Point2f& c) noexcept
+	{
+		count_call(t_orientCalls, g_orientCalls);
+
+		const double ax = a[0], ay = a[1];
+		const double bx = b[0], by = b[1];
+		const double cx = c[0], cy = c[1];
+		const double detLeft = (ax - cx) * (by - cy);
+		const double detRight = (ay - cy) * (bx - cx);
+		const double det = detLeft - detRight;
+
+		double detSum = 0.0;
+		if (detLeft > 0.0)
+		{
+			if (detRight <= 0.0)
+			{
+				return det;
+			}
+			detSum = detLeft + detRight;
+		}
+		else if (detLeft < 0.0)
+		{
+			if (detRight >= 0.0)
+			{
+				return det;
+			}
+			detSum = -detLeft - detRight;
+		}
+		else
+		{
+			return det;
+		}
+
+		const double errorBound = orientErrorBound * detSum;
+		if (det >= errorBound || -det >= errorBound || std::isnan(det))
+		{
+			return det;
+		}
+
+		g_orientExact.fetch_add(1, std::memory_order_relaxed);
+		return orient2d_exact(ax, ay, bx, by, cx, cy);
+	}
+
+	double incircle(const math::Point2f& a, const math::Point2f& b, const math::Point2f& c, const math::Point2f& d) noexcept
+	{
+		count_call(t_incircleCalls, g_incircleCalls);
+
+		const double adx = static_cast<double>(a[0]) - d[0];
+		const double ady = static_cast<double>(a[1]) - d[1];
+		const double bdx = static_cast<double>(b[0]) - d[0];
+		const double bdy = static_cast<double>(b[1]) - d[1];
+		const double cdx = static_cast<double>(c[0]) - d[0];
+		const double cdy = static_cast<double>(c[1]) - d[1];
+
+		const double bdxcdy = bdx * cdy;
+		const double cdxbdy = cdx * bdy;
+		const double aLift = adx * adx + ady * ady;
+		const double cdxady = cdx * ady;
+		const double adxcdy = adx * cdy;
+		const double bLift = bdx * bdx + bdy * bdy;
+		const double adxbdy = adx * bdy;
+		const double bdxady = bdx * ady;
+		const double cLift = cdx * cdx + cdy * cdy;
+
+		const double det = aLift * (bdxcdy - cdxbdy) + bLift * (cdxady - adxcdy) + cLift * (adxbdy - bdxady);
+		const double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * aLift +
+								 (std::abs(cdxady) + std::abs(adxcdy)) * bLift +
+								 (std::abs(adxbdy) + std::abs(bdxady)) * cLift;
+		const double errorBound = incircleErrorBound * permanent;
+		if (det > errorBound || -det > errorBound || std::isnan(det))
+		{
+			return det;
+		}
+
+		g_incircleExact.fetch_add(1, std::memory_order_relaxed);
+		return incircle_exact(a, b, c, d);
+	}
+
+	PredicateStatistics get_predicate_statistics() noexcept
+	{
+		return PredicateStatistics{g_orientCalls.load(std::memory_order_relaxed),
+								   g_orientExact.load(std::memory_order_relaxed),
+								   g_incircleCalls.load(std::memory_order_relaxed),
+								   g_incircleExact.load(std::memory_order_relaxed)};
+	}
+
+	void reset_predicate_statistics() noexcept
+	{
+		g_orientCalls.store(0, std::memory_order_relaxed);
+		g_orientExact.store(0, std::memory_order_relaxed);
+		g_incircleCalls.store(0, std::memory_order_relaxed);
+		g_incircleExact.store(0, std::memory_order_relaxed);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+#include <cstdint>
+#include <clmMath/clm_vector.h>
+
+namespace clm {
+	// Geometric predicates with exactly signed results, after Shewchuk's "Adaptive Precision
+	// Floating-Point Arithmetic and Fast Robust Geometric Predicates". Each one is evaluated in
+	// double precision first, and only when the result is within the rounding error bound of zero
+	// it is recomputed exactly with floating-point expansions. Points are floats, so every product
+	// of two coordinates is exact in double precision and the exact path needs no splitting of
+	// its inputs. NaN inputs (ghost points) give a NaN result.
+
+	// Positive if a, b and c are counterclockwise, negative if clockwise and zero if collinear
+	double orient2d(const math::Point2f&, const math::Point2f&, const math::Point2f&) noexcept;
+	// Positive if d lies inside the circle through the counterclockwise a, b and c, negative if
+	// outside and zero if on it
+	double incircle(const math::Point2f&, const math::Point2f&, const math::Point2f&, const math::Point2f&) noexcept;
+
+	// How often the exact path was needed. Calls are counted per thread and added to the totals
+	// in batches, so the call counts may lag behind by a few thousand per thread.
+	struct PredicateStatistics {
+		uint64_t orientCalls = 0;
+		uint64_t orientExact = 0;
+		uint64_t incircleCalls = 0;
+		uint64_t incircleExact = 0;
+	};
+	PredicateStatistics get_predicate_statistics() noexcept;
+	void reset_predicate_statistics() noexcept;
+}
+
+#endif
\ No newline at end of file
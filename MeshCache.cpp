@@ -0,0 +1,314 @@
+#include "MeshCache.h"
+
+#include <array>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <utility>
+
+namespace clm {
+	namespace {
+		constexpr std::array<char, 4> cacheMagic{ 'F', 'R', 'M', 'C' };
+
+		template<typename T>
+		void write_value(std::ofstream& stream, const T& value)
+		{
+			stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+	}
+
+	MeshCache::MeshCache(std::string fileName, const uint64_t fontKey, const uint64_t tessellationKey)
+		:
+		m_fileName(std::move(fileName)),
+		m_fontKey(fontKey),
+		m_tessellationKey(tessellationKey)
+	{
+		if (!read_cache_file())
+		{
+			create_cache_file();
+		}
+	}
+
+	MeshCache::~MeshCache() noexcept
+	{
+		close();
+	}
+
+	MeshCache::MeshCache(MeshCache&& other) noexcept
+		:
+		m_fileName(std::move(other.m_fileName)),
+		m_fontKey(other.m_fontKey),
+		m_tessellationKey(other.m_tessellationKey),
+		m_open(std::exchange(other.m_open, false)),
+		m_fileSize(other.m_fileSize),
+		m_cacheFile(std::move(other.m_cacheFile)),
+		m_records(std::move(other.m_records)),
+		m_pendingMeshes(std::move(other.m_pendingMeshes)),
+		m_pendingSize(std::exchange(other.m_pendingSize, 0))
+	{
+		other.m_pendingMeshes.clear();
+	}
+
+	MeshCache& MeshCache::operator=(MeshCache&& other) noexcept
+	{
+		if (this != &other)
+		{
+			// The meshes this cache still holds are written before it's replaced
+			close();
+			m_fileName = std::move(other.m_fileName);
+			m_fontKey = other.m_fontKey;
+			m_tessellationKey = other.m_tessellationKey;
+			m_open = std::exchange(other.m_open, false);
+			m_fileSize = other.m_fileSize;
+			m_cacheFile = std::move(other.m_cacheFile);
+			m_records = std::move(other.m_records);
+			m_pendingMeshes = std::move(other.m_pendingMeshes);
+			m_pendingSize = std::exchange(other.m_pendingSize, 0);
+			other.m_pendingMeshes.clear();
+		}
+		return *this;
+	}
+
+	void MeshCache::close() noexcept
+	{
+		try
+		{
+			flush();
+		}
+		catch (...)
+		{
+			// Nothing to do about it, the meshes are rebuilt by the next run
+		}
+		m_pendingMeshes.clear();
+		m_pendingSize = 0;
+		m_open = false;
+	}
+
+	bool MeshCache::is_open() const noexcept
+	{
+		return m_open;
+	}
+
+	bool MeshCache::contains(const uint32_t key) const noexcept
+	{
+		return m_records.contains(key) || m_pendingMeshes.contains(key);
+	}
+
+	bool MeshCache::read_cache_file()
+	{
+		try
+		{
+			m_cacheFile = File::open_file(m_fileName, Endian::Little, Endian::Little, FileMode::Mapped);
+		}
+		catch (...)
+		{
+			// Usually just means there is no cache yet
+			return false;
+		}
+
+		ByteReader reader = m_cacheFile.reader();
+		if (reader.size() < s_headerSize)
+		{
+			return false;
+		}
+		std::array<char, 4> magic{};
+		reader.get_data(magic.data(), magic.size());
+		const uint32_t version = reader.get_data<uint32_t>();
+		const uint64_t fontKey = reader.get_data<uint64_t>();
+		const uint64_t tessellationKey = reader.get_data<uint64_t>();
+		reader.skip(sizeof(uint64_t));
+		if (magic != cacheMagic || version != s_version || fontKey != m_fontKey || tessellationKey != m_tessellationKey)
+		{
+			return false;
+		}
+
+		while (reader.remaining() >= s_recordHeaderSize)
+		{
+			const uint32_t key = reader.get_data<uint32_t>();
+			const uint32_t vertexCount = reader.get_data<uint32_t>();
+			const uint32_t indexCount = reader.get_data<uint32_t>();
+			reader.skip(sizeof(uint32_t));
+			const size_t dataSize = static_cast<size_t>(vertexCount) * 2 * sizeof(float) + static_cast<size_t>(indexCount) * sizeof(uint32_t);
+			// A short or nonsensical record is the tail of an interrupted write
+			if (dataSize > reader.remaining() || indexCount % 3 != 0)
+			{
+				reader.set_position(reader.get_position() - s_recordHeaderSize);
+				break;
+			}
+			m_records[key] = Record{reader.get_position(), vertexCount, indexCount};
+			reader.skip(dataSize);
+		}
+
+		const size_t validSize = reader.get_position();
+		if (validSize != reader.size())
+		{
+			// Drop the partial record so new ones are appended after the last complete one
+			m_cacheFile = File{};
+			std::error_code error{};
+			std::filesystem::resize_file(m_fileName, validSize, error);
+			if (error)
+			{
+				m_records.clear();
+				return false;
+			}
+			try
+			{
+				m_cacheFile = File::open_file(m_fileName, Endian::Little, Endian::Little, FileMode::Mapped);
+			}
+			catch (...)
+			{
+				m_records.clear();
+				return false;
+			}
+		}
+
+		m_fileSize = validSize;
+		m_open = true;
+		return true;
+	}
+
+	void MeshCache::create_cache_file()
+	{
+		// Release the mapping before the file is truncated
+		m_cacheFile = File{};
+		m_records.clear();
+
+		std::ofstream stream{m_fileName, std::ios::binary | std::ios::trunc};
+		stream.write(cacheMagic.data(), cacheMagic.size());
+		write_value(stream, s_version);
+		write_value(stream, m_fontKey);
+		write_value(stream, m_tessellationKey);
+		write_value(stream, uint64_t{0});
+		m_fileSize = s_headerSize;
+		m_open = static_cast<bool>(stream);
+	}
+
+	bool MeshCache::load(const uint32_t key, GlyphMesh& dest) const noexcept(util::release)
+	{
+		const auto recordIter = m_records.find(key);
+		if (recordIter == m_records.end())
+		{
+			const auto pendingIter = m_pendingMeshes.find(key);
+			if (pendingIter == m_pendingMeshes.end())
+			{
+				return false;
+			}
+			dest = pendingIter->second;
+			return true;
+		}
+
+		const Record& record = recordIter->second;
+		ByteReader reader = m_cacheFile.reader(record.offset);
+		dest.vertices.resize(record.vertexCount);
+		// Written by this machine, so the floats need no conversion
+		for (point_t& vertex : dest.vertices)
+		{
+			reader.get_data_raw(vertex[0]);
+			reader.get_data_raw(vertex[1]);
+		}
+		dest.indices.resize(record.indexCount);
+		reader.get_data(dest.indices.data(), dest.indices.size());
+
+		const bool validIndices = std::all_of(dest.indices.begin(),
+											  dest.indices.end(),
+											  [&record](const uint32_t index)
+											  {
+												  return index < record.vertexCount;
+											  });
+		if (!validIndices)
+		{
+			dest = GlyphMesh{};
+			return false;
+		}
+		return true;
+	}
+
+	void MeshCache::append(const uint32_t key, const GlyphMesh& mesh)
+	{
+		add_pending(key, mesh);
+		if (m_pendingSize >= s_flushSize)
+		{
+			flush();
+		}
+	}
+
+	void MeshCache::append(const std::vector<uint32_t>& keys, const std::vector<const GlyphMesh*>& meshes)
+	{
+		for (size_t i = 0; i < keys.size(); i++)
+		{
+			add_pending(keys[i], *meshes[i]);
+		}
+		flush();
+	}
+
+	void MeshCache::add_pending(const uint32_t key, const GlyphMesh& mesh)
+	{
+		if (!m_open || contains(key))
+		{
+			return;
+		}
+		m_pendingSize += mesh.memory_size();
+		m_pendingMeshes.emplace(key, mesh);
+	}
+
+	void MeshCache::flush()
+	{
+		if (m_pendingMeshes.empty())
+		{
+			return;
+		}
+		std::unordered_map<uint32_t, GlyphMesh> pendingMeshes = std::move(m_pendingMeshes);
+		m_pendingMeshes.clear();
+		m_pendingSize = 0;
+		if (!m_open)
+		{
+			return;
+		}
+
+		std::unordered_map<uint32_t, Record> newRecords{};
+		{
+			std::ofstream stream{m_fileName, std::ios::binary | std::ios::app};
+			std::vector<float> coordinates{};
+			for (const auto& [key, mesh] : pendingMeshes)
+			{
+				write_value(stream, key);
+				write_value(stream, static_cast<uint32_t>(mesh.vertices.size()));
+				write_value(stream, static_cast<uint32_t>(mesh.indices.size()));
+				write_value(stream, uint32_t{0});
+
+				coordinates.clear();
+				for (const point_t& vertex : mesh.vertices)
+				{
+					coordinates.push_back(vertex[0]);
+					coordinates.push_back(vertex[1]);
+				}
+				stream.write(reinterpret_cast<const char*>(coordinates.data()), coordinates.size() * sizeof(float));
+				stream.write(reinterpret_cast<const char*>(mesh.indices.data()), mesh.indices.size() * sizeof(uint32_t));
+
+				newRecords[key] = Record{m_fileSize + s_recordHeaderSize,
+										 static_cast<uint32_t>(mesh.vertices.size()),
+										 static_cast<uint32_t>(mesh.indices.size())};
+				m_fileSize += s_recordHeaderSize + coordinates.size() * sizeof(float) + mesh.indices.size() * sizeof(uint32_t);
+			}
+			m_open = static_cast<bool>(stream);
+		}
+		if (!m_open)
+		{
+			return;
+		}
+
+		// The mapping still ends before the new records
+		try
+		{
+			m_cacheFile = File::open_file(m_fileName, Endian::Little, Endian::Little, FileMode::Mapped);
+		}
+		catch (...)
+		{
+			m_cacheFile = File{};
+			m_records.clear();
+			m_open = false;
+			return;
+		}
+		m_records.merge(newRecords);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+
+#include <clmUtil/clm_util.h>
+
+#include <File.h>
+#include <MeshUtil.h>
+
+namespace clm {
+	// Triangulated glyph, ready to be drawn. Every index triple is one triangle of vertices,
+	// the ghost vertex and the triangles using it are already removed.
+	struct GlyphMesh {
+		std::vector<point_t> vertices{};
+		std::vector<uint32_t> indices{};
+
+		// Heap memory held by the mesh, plus the mesh itself
+		size_t memory_size() const noexcept
+		{
+			return sizeof(GlyphMesh) + vertices.capacity() * sizeof(point_t) + indices.capacity() * sizeof(uint32_t);
+		}
+	};
+
+	// Glyph meshes persisted between runs. The file starts with a header identifying the font
+	// (by its checksums) and the tessellation parameters, followed by an append-only sequence of
+	// records. Everything is 4-byte aligned native-endian data, so the file is mapped and the
+	// records are read in place:
+	//   header: "FRMC", uint32 version, uint64 font key, uint64 tessellation key, uint64 reserved
+	//   record: uint32 key, uint32 vertex count, uint32 index count, uint32 reserved,
+	//           vertex count * 2 float, index count * uint32
+	// A file written for another font, another set of tessellation parameters or another version
+	// is discarded and started over. The cache is only an optimization, so I/O errors disable it
+	// instead of being reported.
+	// Appended meshes are kept in memory and written together (with a single remap of the file)
+	// once enough of them have piled up, on flush() or when the cache is destroyed.
+	class MeshCache {
+	public:
+		MeshCache() noexcept = default;
+		MeshCache(std::string, const uint64_t, const uint64_t);
+		~MeshCache() noexcept;
+		// Copies would append to the same file behind each other's back
+		MeshCache(const MeshCache&) = delete;
+		MeshCache(MeshCache&&) noexcept;
+		MeshCache& operator=(const MeshCache&) = delete;
+		MeshCache& operator=(MeshCache&&) noexcept;
+
+		// Meshes are identified by a key chosen by the user of the cache (e.g. glyph ID and level of detail)
+		bool is_open() const noexcept;
+		bool contains(const uint32_t) const noexcept;
+		// Copies the cached mesh with the key into dest, returns false on a miss
+		bool load(const uint32_t, GlyphMesh&) const noexcept(util::release);
+		// Meshes whose key is already cached are skipped, appended ones can be loaded right away.
+		// A batch is written right away, single meshes once enough are pending.
+		void append(const uint32_t, const GlyphMesh&);
+		void append(const std::vector<uint32_t>&, const std::vector<const GlyphMesh*>&);
+		// Writes the pending meshes to the file
+		void flush();
+	private:
+		static constexpr uint32_t s_version = 2;
+		static constexpr size_t s_headerSize = 32;
+		static constexpr size_t s_recordHeaderSize = 16;
+		// Memory held by pending meshes (in bytes) before they are written
+		static constexpr size_t s_flushSize = 256 * 1024;
+
+		bool read_cache_file();
+		void create_cache_file();
+		void add_pending(const uint32_t, const GlyphMesh&);
+		void close() noexcept;
+
+		struct Record {
+			size_t offset = 0;
+			uint32_t vertexCount = 0;
+			uint32_t indexCount = 0;
+		};
+
+		std::string m_fileName;
+		uint64_t m_fontKey = 0;
+		uint64_t m_tessellationKey = 0;
+		bool m_open = false;
+		// End of the last complete record, where the next one is appended
+		size_t m_fileSize = 0;
+		File m_cacheFile;
+		std::unordered_map<uint32_t, Record> m_records;
+		// Appended meshes that aren't written yet
+		std::unordered_map<uint32_t, GlyphMesh> m_pendingMeshes;
+		size_t m_pendingSize = 0;
+	};
+}
+
+#endif
\ No newline at end of file
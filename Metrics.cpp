@@ -0,0 +1,494 @@
+#include "Metrics.h"
+
+#include <string>
+#include <limits>
+#include <iterator>
+#include <algorithm>
+#include <bit>
+
+namespace clm {
+	namespace {
+		constexpr uint16_t GPOS_PAIR_ADJUSTMENT = 2;
+		constexpr uint16_t GPOS_EXTENSION = 9;
+		constexpr uint16_t VALUE_X_ADVANCE = 0x0004;
+
+		constexpr uint16_t KERN_HORIZONTAL = 0x0001;
+		constexpr uint16_t KERN_MINIMUM = 0x0002;
+		constexpr uint16_t KERN_CROSS_STREAM = 0x0004;
+
+		// Offsets come straight from the file, so they're checked even in release builds
+		ByteReader get_subtable_reader(const ByteReader& reader, const size_t offset)
+		{
+			if (offset >= reader.size())
+			{
+				throw std::runtime_error{"Kerning subtable offset beyond the end of its table"};
+			}
+			return reader.subreader(offset);
+		}
+
+		void check_remaining(const ByteReader& reader, const size_t size)
+		{
+			if (reader.remaining() < size)
+			{
+				throw std::runtime_error{"Overshot kerning table"};
+			}
+		}
+
+		size_t get_value_record_size(const uint16_t valueFormat) noexcept
+		{
+			return sizeof(int16_t) * static_cast<size_t>(std::popcount(valueFormat));
+		}
+
+		// x advance of a value record, the fields present are stored in the order of their flag bits
+		int16_t read_x_advance(ByteReader reader, const uint16_t valueFormat) noexcept(util::release)
+		{
+			if (!(valueFormat & VALUE_X_ADVANCE))
+			{
+				return 0;
+			}
+			reader.skip(sizeof(int16_t) * static_cast<size_t>(std::popcount(static_cast<uint16_t>(valueFormat & (VALUE_X_ADVANCE - 1)))));
+			return reader.get_data<int16_t>();
+		}
+	}
+
+	HorizontalMetrics::HorizontalMetrics(ByteReader hmtxReader, const uint16_t numberOfHMetrics, const uint16_t numGlyphs)
+	{
+		if (numberOfHMetrics == 0 || numberOfHMetrics > numGlyphs)
+		{
+			throw std::runtime_error{"Malformed hmtx table"};
+		}
+		const size_t lsbCount = static_cast<size_t>(numGlyphs) - numberOfHMetrics;
+		if (hmtxReader.remaining() < static_cast<size_t>(numberOfHMetrics) * 2 * sizeof(uint16_t) + lsbCount * sizeof(int16_t))
+		{
+			throw std::runtime_error{"Overshot hmtx table"};
+		}
+
+		m_advanceWidths.resize(numberOfHMetrics);
+		m_leftSideBearings.resize(numGlyphs);
+		for (size_t i = 0; i < numberOfHMetrics; i++)
+		{
+			hmtxReader >> m_advanceWidths[i];
+			hmtxReader >> m_leftSideBearings[i];
+		}
+		hmtxReader.get_data(m_leftSideBearings.data() + numberOfHMetrics, lsbCount);
+	}
+
+	uint16_t HorizontalMetrics::get_advance_width(const glyph_id_t glyphID) const noexcept
+	{
+		[[unlikely]] if (m_advanceWidths.empty())
+		{
+			return 0;
+		}
+		return m_advanceWidths[std::min(static_cast<size_t>(glyphID), m_advanceWidths.size() - 1)];
+	}
+
+	int16_t HorizontalMetrics::get_left_side_bearing(const glyph_id_t glyphID) const noexcept
+	{
+		return glyphID < m_leftSideBearings.size() ? m_leftSideBearings[glyphID] : 0;
+	}
+
+	KerningTable KerningTable::from_gpos(ByteReader gposReader)
+	{
+		check_remaining(gposReader, 5 * sizeof(uint16_t));
+		const uint16_t majorVersion = gposReader.get_data<uint16_t>();
+		gposReader.skip(sizeof(uint16_t)); // minorVersion
+		gposReader.skip(sizeof(uint16_t)); // scriptListOffset
+		const uint16_t featureListOffset = gposReader.get_data<uint16_t>();
+		const uint16_t lookupListOffset = gposReader.get_data<uint16_t>();
+		if (majorVersion != 1)
+		{
+			throw std::runtime_error{"Unsupported GPOS version"};
+		}
+
+		KerningTable kerningTable{};
+		if (featureListOffset == 0 || lookupListOffset == 0)
+		{
+			return kerningTable;
+		}
+
+		// Every lookup of a kern feature, whichever script and language it belongs to
+		ByteReader featureListReader = get_subtable_reader(gposReader, featureListOffset);
+		check_remaining(featureListReader, sizeof(uint16_t));
+		const uint16_t featureCount = featureListReader.get_data<uint16_t>();
+		check_remaining(featureListReader, static_cast<size_t>(featureCount) * 6);
+		std::vector<uint16_t> lookupIndices{};
+		for (size_t i = 0; i < featureCount; i++)
+		{
+			std::string featureTag(4, '\0');
+			featureListReader >> featureTag;
+			const uint16_t featureOffset = featureListReader.get_data<uint16_t>();
+			if (!util::compare(featureTag, "kern"))
+			{
+				continue;
+			}
+			ByteReader featureReader = get_subtable_reader(featureListReader, featureOffset);
+			check_remaining(featureReader, 2 * sizeof(uint16_t));
+			featureReader.skip(sizeof(uint16_t)); // featureParamsOffset
+			std::vector<uint16_t> featureLookups(featureReader.get_data<uint16_t>());
+			check_remaining(featureReader, featureLookups.size() * sizeof(uint16_t));
+			featureReader >> featureLookups;
+			lookupIndices.insert(lookupIndices.end(), featureLookups.begin(), featureLookups.end());
+		}
+		// Lookups are applied in lookup list order
+		std::sort(lookupIndices.begin(), lookupIndices.end());
+		lookupIndices.erase(std::unique(lookupIndices.begin(), lookupIndices.end()), lookupIndices.end());
+
+		ByteReader lookupListReader = get_subtable_reader(gposReader, lookupListOffset);
+		check_remaining(lookupListReader, sizeof(uint16_t));
+		const uint16_t lookupCount = lookupListReader.get_data<uint16_t>();
+		check_remaining(lookupListReader, static_cast<size_t>(lookupCount) * sizeof(uint16_t));
+		for (const uint16_t lookupIndex : lookupIndices)
+		{
+			if (lookupIndex >= lookupCount)
+			{
+				throw std::runtime_error{"GPOS lookup index out of range"};
+			}
+			ByteReader lookupReader = get_subtable_reader(lookupListReader, lookupListReader.peek<uint16_t>(sizeof(uint16_t) * (1 + static_cast<size_t>(lookupIndex))));
+			check_remaining(lookupReader, 3 * sizeof(uint16_t));
+			const uint16_t lookupType = lookupReader.get_data<uint16_t>();
+			lookupReader.skip(sizeof(uint16_t)); // lookupFlag
+			const uint16_t subtableCount = lookupReader.get_data<uint16_t>();
+			check_remaining(lookupReader, static_cast<size_t>(subtableCount) * sizeof(uint16_t));
+
+			Lookup lookup{};
+			for (size_t i = 0; i < subtableCount; i++)
+			{
+				ByteReader subtableReader = get_subtable_reader(lookupReader, lookupReader.get_data<uint16_t>());
+				uint16_t subtableType = lookupType;
+				if (lookupType == GPOS_EXTENSION)
+				{
+					// Extension subtables only exist to allow 32 bit offsets to the real subtable
+					check_remaining(subtableReader, 2 * sizeof(uint16_t) + sizeof(uint32_t));
+					subtableReader.skip(sizeof(uint16_t)); // posFormat
+					subtableType = subtableReader.get_data<uint16_t>();
+					subtableReader = get_subtable_reader(subtableReader, subtableReader.get_data<uint32_t>());
+				}
+				if (subtableType == GPOS_PAIR_ADJUSTMENT)
+				{
+					read_pair_pos(subtableReader, lookup);
+				}
+			}
+			if (!lookup.subtables.empty())
+			{
+				kerningTable.m_lookups.push_back(std::move(lookup));
+			}
+		}
+		return kerningTable;
+	}
+
+	KerningTable KerningTable::from_kern(ByteReader kernReader)
+	{
+		KerningTable kerningTable{};
+		check_remaining(kernReader, 2 * sizeof(uint16_t));
+		// Apple's version 1 table (32 bit version, different subtable headers) isn't supported
+		if (kernReader.get_data<uint16_t>() != 0)
+		{
+			return kerningTable;
+		}
+		const uint16_t tableCount = kernReader.get_data<uint16_t>();
+		for (size_t i = 0; i < tableCount; i++)
+		{
+			check_remaining(kernReader, 3 * sizeof(uint16_t));
+			const size_t subtableStart = kernReader.get_position();
+			kernReader.skip(sizeof(uint16_t)); // version
+			const uint16_t length = kernReader.get_data<uint16_t>();
+			const uint16_t coverage = kernReader.get_data<uint16_t>();
+			const uint16_t format = coverage >> 8;
+			if (format != 0 || (coverage & (KERN_HORIZONTAL | KERN_MINIMUM | KERN_CROSS_STREAM)) != KERN_HORIZONTAL)
+			{
+				if (length < 3 * sizeof(uint16_t) || length > kernReader.size() - subtableStart)
+				{
+					break;
+				}
+				kernReader.set_position(subtableStart + length);
+				continue;
+			}
+
+			check_remaining(kernReader, 4 * sizeof(uint16_t));
+			const uint16_t pairCount = kernReader.get_data<uint16_t>();
+			kernReader.skip(3 * sizeof(uint16_t)); // searchRange, entrySelector, rangeShift
+			// length is only 16 bits and overflows for large subtables, the pair count is what counts
+			check_remaining(kernReader, static_cast<size_t>(pairCount) * 6);
+			PairSubtable subtable{};
+			subtable.keys.resize(pairCount);
+			subtable.values.resize(pairCount);
+			for (size_t j = 0; j < pairCount; j++)
+			{
+				kernReader >> subtable.keys[j];
+				kernReader >> subtable.values[j];
+			}
+			if (!std::is_sorted(subtable.keys.begin(), subtable.keys.end()))
+			{
+				throw std::runtime_error{"kern subtable pairs are not sorted"};
+			}
+			kerningTable.m_lookups.push_back(Lookup{{std::move(subtable)}});
+		}
+		return kerningTable;
+	}
+
+	void KerningTable::read_pair_pos(ByteReader subtableReader, Lookup& lookup)
+	{
+		const ByteReader pairPosReader = subtableReader;
+		check_remaining(subtableReader, 5 * sizeof(uint16_t));
+		const uint16_t posFormat = subtableReader.get_data<uint16_t>();
+		const uint16_t coverageOffset = subtableReader.get_data<uint16_t>();
+		const uint16_t valueFormat1 = subtableReader.get_data<uint16_t>();
+		const uint16_t valueFormat2 = subtableReader.get_data<uint16_t>();
+		const size_t pairValueSize = get_value_record_size(valueFormat1) + get_value_record_size(valueFormat2);
+		const glyph_ranges_t coverage = read_coverage(get_subtable_reader(pairPosReader, coverageOffset));
+
+		if (posFormat == 1)
+		{
+			// Individual pairs, flattened into sorted keys
+			const uint16_t pairSetCount = subtableReader.get_data<uint16_t>();
+			check_remaining(subtableReader, static_cast<size_t>(pairSetCount) * sizeof(uint16_t));
+			PairSubtable subtable{};
+			for (const GlyphRange& range : coverage)
+			{
+				for (uint32_t firstGlyph = range.start; firstGlyph <= range.end; firstGlyph++)
+				{
+					const size_t coverageIndex = static_cast<size_t>(range.value) + (firstGlyph - range.start);
+					if (coverageIndex >= pairSetCount)
+					{
+						break;
+					}
+					ByteReader pairSetReader = get_subtable_reader(pairPosReader, subtableReader.peek<uint16_t>(subtableReader.get_position() + coverageIndex * sizeof(uint16_t)));
+					check_remaining(pairSetReader, sizeof(uint16_t));
+					const uint16_t pairValueCount = pairSetReader.get_data<uint16_t>();
+					check_remaining(pairSetReader, static_cast<size_t>(pairValueCount) * (sizeof(uint16_t) + pairValueSize));
+					for (size_t i = 0; i < pairValueCount; i++)
+					{
+						const glyph_id_t secondGlyph = pairSetReader.get_data<uint16_t>();
+						subtable.keys.push_back((firstGlyph << 16) | secondGlyph);
+						subtable.values.push_back(read_x_advance(pairSetReader, valueFormat1));
+						pairSetReader.skip(pairValueSize);
+					}
+				}
+			}
+
+			// Coverage and pair sets are sorted already in well-formed fonts, the first of duplicate pairs wins
+			std::vector<uint32_t> order(subtable.keys.size());
+			for (uint32_t i = 0; i < order.size(); i++)
+			{
+				order[i] = i;
+			}
+			std::stable_sort(order.begin(),
+							 order.end(),
+							 [&subtable](const uint32_t lhs, const uint32_t rhs)
+							 {
+								 return subtable.keys[lhs] < subtable.keys[rhs];
+							 });
+			PairSubtable sortedSubtable{};
+			sortedSubtable.keys.reserve(order.size());
+			sortedSubtable.values.reserve(order.size());
+			for (const uint32_t i : order)
+			{
+				if (sortedSubtable.keys.empty() || sortedSubtable.keys.back() != subtable.keys[i])
+				{
+					sortedSubtable.keys.push_back(subtable.keys[i]);
+					sortedSubtable.values.push_back(subtable.values[i]);
+				}
+			}
+			lookup.subtables.push_back(std::move(sortedSubtable));
+		}
+		else if (posFormat == 2)
+		{
+			// Pairs of glyph classes, kept as a class1Count x class2Count matrix
+			check_remaining(subtableReader, 4 * sizeof(uint16_t));
+			const uint16_t classDef1Offset = subtableReader.get_data<uint16_t>();
+			const uint16_t classDef2Offset = subtableReader.get_data<uint16_t>();
+			const uint16_t class1Count = subtableReader.get_data<uint16_t>();
+			const uint16_t class2Count = subtableReader.get_data<uint16_t>();
+			check_remaining(subtableReader, static_cast<size_t>(class1Count) * class2Count * pairValueSize);
+
+			ClassSubtable subtable{};
+			subtable.coverage = coverage;
+			subtable.classDef1 = read_class_def(get_subtable_reader(pairPosReader, classDef1Offset));
+			subtable.classDef2 = read_class_def(get_subtable_reader(pairPosReader, classDef2Offset));
+			subtable.class2Count = class2Count;
+			subtable.values.resize(static_cast<size_t>(class1Count) * class2Count);
+			for (int16_t& value : subtable.values)
+			{
+				value = read_x_advance(subtableReader, valueFormat1);
+				subtableReader.skip(pairValueSize);
+			}
+			lookup.subtables.push_back(std::move(subtable));
+		}
+	}
+
+	KerningTable::glyph_ranges_t KerningTable::read_coverage(ByteReader coverageReader)
+	{
+		check_remaining(coverageReader, 2 * sizeof(uint16_t));
+		const uint16_t coverageFormat = coverageReader.get_data<uint16_t>();
+		const uint16_t count = coverageReader.get_data<uint16_t>();
+		glyph_ranges_t ranges{};
+		if (coverageFormat == 1)
+		{
+			// Runs of consecutive glyphs become a single range
+			check_remaining(coverageReader, static_cast<size_t>(count) * sizeof(uint16_t));
+			for (uint16_t i = 0; i < count; i++)
+			{
+				const glyph_id_t glyphID = coverageReader.get_data<uint16_t>();
+				if (!ranges.empty() && ranges.back().end + 1 == glyphID)
+				{
+					ranges.back().end = glyphID;
+				}
+				else
+				{
+					ranges.push_back(GlyphRange{glyphID, glyphID, i});
+				}
+			}
+		}
+		else if (coverageFormat == 2)
+		{
+			check_remaining(coverageReader, static_cast<size_t>(count) * 3 * sizeof(uint16_t));
+			ranges.resize(count);
+			for (GlyphRange& range : ranges)
+			{
+				coverageReader >> range.start;
+				coverageReader >> range.end;
+				coverageReader >> range.value;
+			}
+		}
+		else
+		{
+			throw std::runtime_error{"Unknown coverage table format"};
+		}
+
+		std::sort(ranges.begin(),
+				  ranges.end(),
+				  [](const GlyphRange& lhs, const GlyphRange& rhs)
+				  {
+					  return lhs.start < rhs.start;
+				  });
+		return ranges;
+	}
+
+	KerningTable::glyph_ranges_t KerningTable::read_class_def(ByteReader classDefReader)
+	{
+		check_remaining(classDefReader, sizeof(uint16_t));
+		const uint16_t classFormat = classDefReader.get_data<uint16_t>();
+		glyph_ranges_t ranges{};
+		if (classFormat == 1)
+		{
+			// Runs of consecutive glyphs with the same class become a single range
+			check_remaining(classDefReader, 2 * sizeof(uint16_t));
+			const uint16_t startGlyphID = classDefReader.get_data<uint16_t>();
+			const uint16_t glyphCount = classDefReader.get_data<uint16_t>();
+			check_remaining(classDefReader, static_cast<size_t>(glyphCount) * sizeof(uint16_t));
+			for (uint32_t i = 0; i < glyphCount; i++)
+			{
+				const uint16_t classValue = classDefReader.get_data<uint16_t>();
+				const uint32_t glyphID = startGlyphID + i;
+				if (glyphID > std::numeric_limits<glyph_id_t>::max())
+				{
+					break;
+				}
+				if (!ranges.empty() && ranges.back().end + 1u == glyphID && ranges.back().value == classValue)
+				{
+					ranges.back().end = static_cast<glyph_id_t>(glyphID);
+				}
+				else
+				{
+					ranges.push_back(GlyphRange{static_cast<glyph_id_t>(glyphID), static_cast<glyph_id_t>(glyphID), classValue});
+				}
+			}
+		}
+		else if (classFormat == 2)
+		{
+			check_remaining(classDefReader, sizeof(uint16_t));
+			ranges.resize(classDefReader.get_data<uint16_t>());
+			check_remaining(classDefReader, ranges.size() * 3 * sizeof(uint16_t));
+			for (GlyphRange& range : ranges)
+			{
+				classDefReader >> range.start;
+				classDefReader >> range.end;
+				classDefReader >> range.value;
+			}
+			std::sort(ranges.begin(),
+					  ranges.end(),
+					  [](const GlyphRange& lhs, const GlyphRange& rhs)
+					  {
+						  return lhs.start < rhs.start;
+					  });
+		}
+		else
+		{
+			throw std::runtime_error{"Unknown class definition table format"};
+		}
+		return ranges;
+	}
+
+	const KerningTable::GlyphRange* KerningTable::find_range(const glyph_ranges_t& ranges, const glyph_id_t glyphID) noexcept
+	{
+		// Last range starting at or before the glyph
+		const auto rangeIter = std::upper_bound(ranges.begin(),
+												ranges.end(),
+												glyphID,
+												[](const glyph_id_t glyph, const GlyphRange& range)
+												{
+													return glyph < range.start;
+												});
+		if (rangeIter == ranges.begin() || std::prev(rangeIter)->end < glyphID)
+		{
+			return nullptr;
+		}
+		return &*std::prev(rangeIter);
+	}
+
+	bool KerningTable::get_kerning(const subtable_t& subtable, const glyph_id_t left, const glyph_id_t right, int32_t& kerning) noexcept
+	{
+		if (const PairSubtable* pairSubtable = std::get_if<PairSubtable>(&subtable))
+		{
+			const uint32_t key = (static_cast<uint32_t>(left) << 16) | right;
+			const auto keyIter = std::lower_bound(pairSubtable->keys.begin(), pairSubtable->keys.end(), key);
+			if (keyIter == pairSubtable->keys.end() || *keyIter != key)
+			{
+				return false;
+			}
+			kerning = pairSubtable->values[static_cast<size_t>(keyIter - pairSubtable->keys.begin())];
+			return true;
+		}
+
+		const ClassSubtable& classSubtable = std::get<ClassSubtable>(subtable);
+		if (find_range(classSubtable.coverage, left) == nullptr)
+		{
+			return false;
+		}
+		// Glyphs without a class are in class 0
+		const GlyphRange* class1 = find_range(classSubtable.classDef1, left);
+		const GlyphRange* class2 = find_range(classSubtable.classDef2, right);
+		const size_t class1Value = class1 != nullptr ? class1->value : 0;
+		const size_t class2Value = class2 != nullptr ? class2->value : 0;
+		const size_t index = class1Value * classSubtable.class2Count + class2Value;
+		if (class2Value >= classSubtable.class2Count || index >= classSubtable.values.size())
+		{
+			return false;
+		}
+		kerning = classSubtable.values[index];
+		return true;
+	}
+
+	int32_t KerningTable::get_kerning(const glyph_id_t left, const glyph_id_t right) const noexcept
+	{
+		int32_t kerning = 0;
+		for (const Lookup& lookup : m_lookups)
+		{
+			for (const subtable_t& subtable : lookup.subtables)
+			{
+				int32_t subtableKerning = 0;
+				if (get_kerning(subtable, left, right, subtableKerning))
+				{
+					kerning += subtableKerning;
+					break;
+				}
+			}
+		}
+		return kerning;
+	}
+
+	bool KerningTable::empty() const noexcept
+	{
+		return m_lookups.empty();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#ifndef METRICS_H
+#define METRICS_H
+#include <vector>
+#include <variant>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+
+#include <clmUtil/clm_util.h>
+
+#include <ByteReader.h>
+#include <CMap.h>
+
+namespace clm {
+	// hmtx, the advance width and left side bearing of every glyph (in font units). Only the first
+	// numberOfHMetrics glyphs have their own advance, the glyphs after them (usually a monospaced
+	// run at the end of the font) share the last advance and only store a left side bearing.
+	class HorizontalMetrics {
+	public:
+		HorizontalMetrics() noexcept = default;
+		HorizontalMetrics(ByteReader, const uint16_t, const uint16_t);
+		~HorizontalMetrics() noexcept = default;
+		HorizontalMetrics(const HorizontalMetrics&) = default;
+		HorizontalMetrics(HorizontalMetrics&&) noexcept = default;
+		HorizontalMetrics& operator=(const HorizontalMetrics&) = default;
+		HorizontalMetrics& operator=(HorizontalMetrics&&) noexcept = default;
+
+		uint16_t get_advance_width(const glyph_id_t) const noexcept;
+		int16_t get_left_side_bearing(const glyph_id_t) const noexcept;
+	private:
+		std::vector<uint16_t> m_advanceWidths;
+		std::vector<int16_t> m_leftSideBearings;
+	};
+
+	// Pair kerning from GPOS (PairPos lookups of the kern feature) or, for fonts without one, from the
+	// legacy kern table (format 0). Glyph pairs are kept as sorted (left << 16 | right) keys that are
+	// binary searched, class based subtables keep their coverage and class definitions as sorted
+	// glyph ranges. Only the horizontal advance adjustment of the first glyph is applied.
+	class KerningTable {
+	public:
+		KerningTable() noexcept = default;
+		~KerningTable() noexcept = default;
+		KerningTable(const KerningTable&) = default;
+		KerningTable(KerningTable&&) noexcept = default;
+		KerningTable& operator=(const KerningTable&) = default;
+		KerningTable& operator=(KerningTable&&) noexcept = default;
+
+		static KerningTable from_gpos(ByteReader);
+		static KerningTable from_kern(ByteReader);
+
+		// Adjustment of the left glyph's advance (in font units), 0 for pairs that aren't kerned
+		int32_t get_kerning(const glyph_id_t, const glyph_id_t) const noexcept;
+		bool empty() const noexcept;
+	private:
+		struct GlyphRange {
+			glyph_id_t start;
+			glyph_id_t end;
+			// Class value or the coverage index of start
+			uint16_t value;
+		};
+		using glyph_ranges_t = std::vector<GlyphRange>;
+
+		struct PairSubtable {
+			std::vector<uint32_t> keys;
+			std::vector<int16_t> values;
+		};
+		struct ClassSubtable {
+			glyph_ranges_t coverage;
+			glyph_ranges_t classDef1;
+			glyph_ranges_t classDef2;
+			uint16_t class2Count;
+			// class1Count * class2Count adjustments
+			std::vector<int16_t> values;
+		};
+		using subtable_t = std::variant<PairSubtable, ClassSubtable>;
+		// Subtables of a lookup are tried in order until one has the pair, lookups add up
+		struct Lookup {
+			std::vector<subtable_t> subtables;
+		};
+
+		static void read_pair_pos(ByteReader, Lookup&);
+		static glyph_ranges_t read_coverage(ByteReader);
+		static glyph_ranges_t read_class_def(ByteReader);
+		static const GlyphRange* find_range(const glyph_ranges_t&, const glyph_id_t) noexcept;
+		static bool get_kerning(const subtable_t&, const glyph_id_t, const glyph_id_t, int32_t&) noexcept;
+
+		std::vector<Lookup> m_lookups;
+	};
+}
+
+#endif
\ No newline at end of file
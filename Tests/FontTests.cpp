@@ -0,0 +1,105 @@
+#include <cmath>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include <Font.h>
+
+#include "TestFont.h"
+
+namespace {
+	using namespace clm;
+	using namespace clm::test;
+
+	void check(const bool condition, const std::string& message)
+	{
+		if (!condition)
+		{
+			throw std::runtime_error{message};
+		}
+	}
+
+	TestGlyph make_square(const char32_t character)
+	{
+		return TestGlyph{character, 1000, {{ {100, 0}, {100, 700}, {600, 700}, {600, 0} }}};
+	}
+
+	// A font whose only kern lookup uses an unknown coverage format still loads, and the pair
+	// kerning comes from its kern table instead
+	void unsupported_gpos_kerning()
+	{
+		TableWriter gpos{};
+		gpos.u16(1).u16(0).u16(0).u16(10).u16(24);    // header, no script list
+		gpos.u16(1).tag("kern").u16(8);               // feature list
+		gpos.u16(0).u16(1).u16(0);                    // kern feature, lookup 0
+		gpos.u16(1).u16(4);                           // lookup list
+		gpos.u16(2).u16(0).u16(1).u16(8);             // pair adjustment lookup
+		gpos.u16(1).u16(10).u16(0x0004).u16(0).u16(0); // pair adjustment subtable
+		gpos.u16(3).u16(0);                           // coverage in an unknown format
+
+		TableWriter kern{};
+		kern.u16(0).u16(1);
+		kern.u16(0).u16(20).u16(0x0001);
+		kern.u16(1).u16(6).u16(0).u16(0);
+		kern.u16(1).u16(2).i16(-100);
+
+		TestFont testFont{};
+		testFont.add_glyph(make_square(U'A'));
+		testFont.add_glyph(make_square(U'V'));
+		testFont.add_table("GPOS", gpos.data());
+		testFont.add_table("kern", kern.data());
+
+		Font font{testFont.write("clm_unsupported_gpos.ttf"), 12.0f};
+		std::vector<point_t> vertices{};
+		IndexBuffer indices{};
+		const point_t pen = font.layout_and_tessellate(U"AV", point_t{0.0f, 0.0f}, vertices, indices);
+		check(std::abs(pen[0] - 1.9f) < 1e-4f, std::format("Expected the kern table's kerning, the pen ended at {}", pen[0]));
+	}
+
+	// Point sizes of 0 and below one pixel per em get the coarsest level of detail, not the finest
+	void tiny_point_size_lod()
+	{
+		TestFont testFont{};
+		// A circle made of four quadratic curves
+		testFont.add_glyph(TestGlyph{U'O', 1000, {{ {0, 500}, {0, 1000, false}, {500, 1000}, {1000, 1000, false},
+													{1000, 500}, {1000, 0, false}, {500, 0}, {0, 0, false} }}});
+		Font font{testFont.write("clm_tiny_point_size.ttf"), 12.0f};
+
+		const size_t coarsest = font.get_triangles(U'O', 1.0f).size();
+		const size_t finest = font.get_triangles(U'O', 10000.0f).size();
+		check(coarsest < finest, std::format("Expected fewer triangles at 1pt ({}) than at 10000pt ({})", coarsest, finest));
+		for (const float pointSize : { 0.0f, 0.25f, 0.5f, -1.0f })
+		{
+			const size_t triangles = font.get_triangles(U'O', pointSize).size();
+			check(triangles == coarsest, std::format("{} triangles at {}pt, expected the {} of the coarsest level", triangles, pointSize, coarsest));
+		}
+	}
+
+	const std::map<std::string, std::function<void()>> s_tests{
+		{ "unsupported_gpos_kerning", unsupported_gpos_kerning },
+		{ "tiny_point_size_lod", tiny_point_size_lod }
+	};
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 2 || !s_tests.contains(argv[1]))
+	{
+		std::cerr << "Usage: FontTests <test name>\n";
+		return 2;
+	}
+
+	try
+	{
+		s_tests.at(argv[1])();
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << std::format("{} failed: {}\n", argv[1], e.what());
+		return 1;
+	}
+	return 0;
+}
\ No newline at end of file
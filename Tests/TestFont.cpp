@@ -0,0 +1,222 @@
+#include "TestFont.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace clm::test {
+	namespace {
+		constexpr uint16_t s_unitsPerEm = 1000;
+
+		uint32_t calc_checksum(const std::vector<uint8_t>& data, const size_t offset, const size_t length) noexcept
+		{
+			uint32_t checksum = 0;
+			for (size_t i = 0; i < length; i++)
+			{
+				checksum += static_cast<uint32_t>(data[offset + i]) << (8 * (3 - i % 4));
+			}
+			return checksum;
+		}
+	}
+
+	TableWriter& TableWriter::u8(const uint8_t value)
+	{
+		m_data.push_back(value);
+		return *this;
+	}
+
+	TableWriter& TableWriter::u16(const uint16_t value)
+	{
+		u8(static_cast<uint8_t>(value >> 8));
+		return u8(static_cast<uint8_t>(value));
+	}
+
+	TableWriter& TableWriter::i16(const int16_t value)
+	{
+		return u16(static_cast<uint16_t>(value));
+	}
+
+	TableWriter& TableWriter::u32(const uint32_t value)
+	{
+		u16(static_cast<uint16_t>(value >> 16));
+		return u16(static_cast<uint16_t>(value));
+	}
+
+	TableWriter& TableWriter::tag(const std::string& tableTag)
+	{
+		for (size_t i = 0; i < 4; i++)
+		{
+			u8(i < tableTag.size() ? static_cast<uint8_t>(tableTag[i]) : static_cast<uint8_t>(' '));
+		}
+		return *this;
+	}
+
+	TableWriter& TableWriter::zeros(const size_t count)
+	{
+		m_data.insert(m_data.end(), count, 0);
+		return *this;
+	}
+
+	void TestFont::add_glyph(TestGlyph glyph)
+	{
+		m_glyphs.push_back(std::move(glyph));
+	}
+
+	void TestFont::add_table(std::string tableTag, std::vector<uint8_t> data)
+	{
+		m_extraTables.emplace_back(std::move(tableTag), std::move(data));
+	}
+
+	std::string TestFont::write(const std::string& fileName) const
+	{
+		const uint16_t glyphCount = static_cast<uint16_t>(m_glyphs.size() + 1);
+
+		// glyf and loca (long offsets), glyph 0 has no outline
+		TableWriter glyf{};
+		TableWriter loca{};
+		loca.u32(0).u32(0);
+		for (const TestGlyph& glyph : m_glyphs)
+		{
+			int16_t xMin = 0, yMin = 0, xMax = 0, yMax = 0;
+			uint16_t pointCount = 0;
+			for (const auto& contour : glyph.contours)
+			{
+				for (const TestPoint& p : contour)
+				{
+					xMin = pointCount == 0 ? p.x : std::min(xMin, p.x);
+					yMin = pointCount == 0 ? p.y : std::min(yMin, p.y);
+					xMax = pointCount == 0 ? p.x : std::max(xMax, p.x);
+					yMax = pointCount == 0 ? p.y : std::max(yMax, p.y);
+					pointCount++;
+				}
+			}
+
+			glyf.i16(static_cast<int16_t>(glyph.contours.size())).i16(xMin).i16(yMin).i16(xMax).i16(yMax);
+			uint16_t contourEnd = 0;
+			for (const auto& contour : glyph.contours)
+			{
+				contourEnd += static_cast<uint16_t>(contour.size());
+				glyf.u16(contourEnd - 1);
+			}
+			glyf.u16(0); // instructionLength
+			// Every coordinate is stored as a 16 bit delta, so the flags only carry the on-curve bit
+			std::vector<const TestPoint*> points{};
+			for (const auto& contour : glyph.contours)
+			{
+				for (const TestPoint& p : contour)
+				{
+					points.push_back(&p);
+				}
+			}
+			for (const TestPoint* p : points)
+			{
+				glyf.u8(p->onCurve ? 0x01 : 0x00);
+			}
+			int16_t previous = 0;
+			for (const TestPoint* p : points)
+			{
+				glyf.i16(static_cast<int16_t>(p->x - previous));
+				previous = p->x;
+			}
+			previous = 0;
+			for (const TestPoint* p : points)
+			{
+				glyf.i16(static_cast<int16_t>(p->y - previous));
+				previous = p->y;
+			}
+			glyf.zeros((4 - glyf.size() % 4) % 4);
+			loca.u32(static_cast<uint32_t>(glyf.size()));
+		}
+
+		TableWriter head{};
+		head.u16(1).u16(0).u32(0x00010000).u32(0).u32(0x5F0F3CF5).u16(0).u16(s_unitsPerEm);
+		head.zeros(16); // created, modified
+		head.i16(0).i16(0).i16(static_cast<int16_t>(s_unitsPerEm)).i16(static_cast<int16_t>(s_unitsPerEm));
+		head.u16(0).u16(8).i16(2).i16(1).i16(0); // macStyle, lowestRecPPEM, fontDirectionHint, indexToLocFormat, glyphDataFormat
+
+		TableWriter hhea{};
+		hhea.u16(1).u16(0).i16(800).i16(-200).i16(0).u16(s_unitsPerEm).i16(0).i16(0).i16(static_cast<int16_t>(s_unitsPerEm));
+		hhea.i16(1).i16(0).i16(0).zeros(8).i16(0).u16(glyphCount);
+
+		TableWriter hmtx{};
+		hmtx.u16(s_unitsPerEm / 2).i16(0);
+		for (const TestGlyph& glyph : m_glyphs)
+		{
+			hmtx.u16(glyph.advanceWidth).i16(0);
+		}
+
+		TableWriter maxp{};
+		maxp.u32(0x00010000).u16(glyphCount).zeros(26);
+
+		// Format 12, one group per glyph
+		std::vector<std::pair<char32_t, uint16_t>> characters{};
+		for (size_t i = 0; i < m_glyphs.size(); i++)
+		{
+			characters.emplace_back(m_glyphs[i].character, static_cast<uint16_t>(i + 1));
+		}
+		std::sort(characters.begin(), characters.end());
+		TableWriter cmap{};
+		cmap.u16(0).u16(1).u16(3).u16(10).u32(12);
+		cmap.u16(12).u16(0).u32(static_cast<uint32_t>(16 + 12 * characters.size())).u32(0).u32(static_cast<uint32_t>(characters.size()));
+		for (const auto& [character, glyphID] : characters)
+		{
+			cmap.u32(static_cast<uint32_t>(character)).u32(static_cast<uint32_t>(character)).u32(glyphID);
+		}
+
+		TableWriter name{};
+		name.u16(0).u16(0).u16(6);
+		TableWriter os2{};
+		os2.u16(0).zeros(76);
+		TableWriter post{};
+		post.u32(0x00030000).zeros(28);
+
+		std::vector<std::pair<std::string, std::vector<uint8_t>>> tables{
+			{ "OS/2", os2.data() }, { "cmap", cmap.data() }, { "glyf", glyf.data() }, { "head", head.data() },
+			{ "hhea", hhea.data() }, { "hmtx", hmtx.data() }, { "loca", loca.data() }, { "maxp", maxp.data() },
+			{ "name", name.data() }, { "post", post.data() }
+		};
+		tables.insert(tables.end(), m_extraTables.begin(), m_extraTables.end());
+		std::sort(tables.begin(), tables.end());
+
+		const uint16_t tableCount = static_cast<uint16_t>(tables.size());
+		uint16_t entrySelector = 0;
+		while ((2u << entrySelector) <= tableCount)
+		{
+			entrySelector++;
+		}
+		const uint16_t searchRange = static_cast<uint16_t>((1u << entrySelector) * 16);
+		TableWriter directory{};
+		directory.u32(0x00010000).u16(tableCount).u16(searchRange).u16(entrySelector).u16(static_cast<uint16_t>(tableCount * 16 - searchRange));
+
+		std::vector<uint8_t> font(directory.size() + 16 * tables.size());
+		size_t headOffset = 0;
+		for (const auto& [tableTag, data] : tables)
+		{
+			const size_t offset = font.size();
+			if (tableTag == "head")
+			{
+				headOffset = offset;
+			}
+			font.insert(font.end(), data.begin(), data.end());
+			font.resize((font.size() + 3) & ~size_t{3});
+			directory.tag(tableTag).u32(calc_checksum(font, offset, data.size())).u32(static_cast<uint32_t>(offset)).u32(static_cast<uint32_t>(data.size()));
+		}
+		std::copy(directory.data().begin(), directory.data().end(), font.begin());
+		const uint32_t checksumAdjustment = 0xB1B0AFBA - calc_checksum(font, 0, font.size());
+		for (size_t i = 0; i < 4; i++)
+		{
+			font[headOffset + 8 + i] = static_cast<uint8_t>(checksumAdjustment >> (8 * (3 - i)));
+		}
+
+		const std::filesystem::path path = std::filesystem::temp_directory_path() / fileName;
+		std::ofstream file{path, std::ios::binary | std::ios::trunc};
+		file.write(reinterpret_cast<const char*>(font.data()), static_cast<std::streamsize>(font.size()));
+		if (!file)
+		{
+			throw std::runtime_error{"Unable to write the test font"};
+		}
+		return path.generic_string();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef TEST_FONT_H
+#define TEST_FONT_H
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace clm::test {
+	// Appends big-endian values, like they're stored in font files
+	class TableWriter {
+	public:
+		TableWriter& u8(const uint8_t);
+		TableWriter& u16(const uint16_t);
+		TableWriter& i16(const int16_t);
+		TableWriter& u32(const uint32_t);
+		TableWriter& tag(const std::string&);
+		TableWriter& zeros(const size_t);
+		const std::vector<uint8_t>& data() const noexcept { return m_data; }
+		size_t size() const noexcept { return m_data.size(); }
+	private:
+		std::vector<uint8_t> m_data{};
+	};
+
+	// A point of a simple glyph, in font units
+	struct TestPoint {
+		int16_t x;
+		int16_t y;
+		bool onCurve = true;
+	};
+
+	struct TestGlyph {
+		char32_t character;
+		uint16_t advanceWidth;
+		// Outer contours run clockwise
+		std::vector<std::vector<TestPoint>> contours;
+	};
+
+	// Builds a small but complete TrueType font (1000 units per em, glyph 0 is an empty .notdef)
+	// with correct checksums, so tests don't depend on the fonts installed on the machine
+	class TestFont {
+	public:
+		void add_glyph(TestGlyph);
+		// Extra tables (GPOS, kern, ...) are stored as given
+		void add_table(std::string, std::vector<uint8_t>);
+		// Writes the font to the temp directory and returns its path
+		std::string write(const std::string&) const;
+	private:
+		std::vector<TestGlyph> m_glyphs{};
+		std::vector<std::pair<std::string, std::vector<uint8_t>>> m_extraTables{};
+	};
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "ThreadPool.h"
+
+#include <exception>
+
+namespace clm {
+	ThreadPool::ThreadPool(const size_t threadCount)
+	{
+		const size_t count = threadCount == 0 ? 1 : threadCount;
+		m_queues.reserve(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			m_queues.push_back(std::make_unique<WorkQueue>());
+		}
+		m_threads.reserve(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			m_threads.emplace_back(&ThreadPool::worker_loop, this, i);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock{m_stateMutex};
+			m_stopping = true;
+		}
+		m_wake.notify_all();
+		for (std::thread& thread : m_threads)
+		{
+			thread.join();
+		}
+	}
+
+	size_t ThreadPool::thread_count() const noexcept
+	{
+		return m_threads.size();
+	}
+
+	void ThreadPool::submit(task_t task)
+	{
+		WorkQueue& queue = *m_queues[m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size()];
+		m_pending.fetch_add(1);
+		{
+			// Counted before the task can be popped, so m_queued can't drop below zero. Taking the lock
+			// orders this with a worker checking m_queued before it goes to sleep.
+			std::lock_guard<std::mutex> lock{m_stateMutex};
+			m_queued.fetch_add(1);
+		}
+		{
+			std::lock_guard<std::mutex> lock{queue.mutex};
+			queue.tasks.push_back(std::move(task));
+		}
+		m_wake.notify_one();
+	}
+
+	void ThreadPool::wait_idle()
+	{
+		std::unique_lock<std::mutex> lock{m_stateMutex};
+		m_idle.wait(lock, [this]() { return m_pending.load() == 0; });
+	}
+
+	void ThreadPool::parallel_for(const size_t count, const std::function<void(size_t)>& func)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		// Completion is signalled under the mutex so the waiter can't return (and destroy these)
+		// while the last task is still notifying
+		std::mutex doneMutex{};
+		std::condition_variable doneCondition{};
+		size_t remaining = count;
+		std::exception_ptr error{};
+		for (size_t i = 0; i < count; i++)
+		{
+			submit([&func, &doneMutex, &doneCondition, &remaining, &error, i]()
+				   {
+					   try
+					   {
+						   func(i);
+					   }
+					   catch (...)
+					   {
+						   std::lock_guard<std::mutex> lock{doneMutex};
+						   if (!error)
+						   {
+							   error = std::current_exception();
+						   }
+					   }
+					   std::lock_guard<std::mutex> lock{doneMutex};
+					   remaining -= 1;
+					   if (remaining == 0)
+					   {
+						   doneCondition.notify_all();
+					   }
+				   });
+		}
+		{
+			std::unique_lock<std::mutex> lock{doneMutex};
+			doneCondition.wait(lock, [&remaining]() { return remaining == 0; });
+		}
+
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+
+	bool ThreadPool::try_pop(const size_t index, task_t& task)
+	{
+		{
+			// Newest task of our own queue first, it's the most likely to still be in cache
+			WorkQueue& queue = *m_queues[index];
+			std::lock_guard<std::mutex> lock{queue.mutex};
+			if (!queue.tasks.empty())
+			{
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+				m_queued.fetch_sub(1);
+				return true;
+			}
+		}
+		for (size_t i = 1; i < m_queues.size(); i++)
+		{
+			// Steal the oldest task of another queue
+			WorkQueue& queue = *m_queues[(index + i) % m_queues.size()];
+			std::lock_guard<std::mutex> lock{queue.mutex};
+			if (!queue.tasks.empty())
+			{
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+				m_queued.fetch_sub(1);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void ThreadPool::worker_loop(const size_t index)
+	{
+		while (true)
+		{
+			task_t task{};
+			if (try_pop(index, task))
+			{
+				task();
+				if (m_pending.fetch_sub(1) == 1)
+				{
+					std::lock_guard<std::mutex> lock{m_stateMutex};
+					m_idle.notify_all();
+				}
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock{m_stateMutex};
+			m_wake.wait(lock, [this]() { return m_stopping || m_queued.load() > 0; });
+			if (m_stopping && m_queued.load() == 0)
+			{
+				return;
+			}
+		}
+	}
+}
\ No newline at end of file
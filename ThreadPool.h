@@ -0,0 +1,57 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstddef>
+
+namespace clm {
+	// Fixed set of worker threads, each with its own task deque. Workers take their newest task
+	// first and steal the oldest tasks of other workers once their own deque is empty, so uneven
+	// task costs (e.g. glyphs of very different complexity) balance out across the pool.
+	class ThreadPool {
+	public:
+		using task_t = std::function<void()>;
+
+		ThreadPool(const size_t = std::thread::hardware_concurrency());
+		~ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		ThreadPool& operator=(ThreadPool&&) = delete;
+
+		size_t thread_count() const noexcept;
+		void submit(task_t);
+		// Blocks until every submitted task has finished
+		void wait_idle();
+		// Runs func(i) for every i in [0, count) on the pool and blocks until all calls have returned.
+		// The first exception thrown by a call is rethrown here. Must not be called from a pool thread.
+		void parallel_for(const size_t, const std::function<void(size_t)>&);
+	private:
+		void worker_loop(const size_t);
+		bool try_pop(const size_t, task_t&);
+
+		struct WorkQueue {
+			std::mutex mutex;
+			std::deque<task_t> tasks;
+		};
+
+		std::vector<std::unique_ptr<WorkQueue>> m_queues;
+		std::vector<std::thread> m_threads;
+		std::mutex m_stateMutex;
+		std::condition_variable m_wake;
+		std::condition_variable m_idle;
+		// Tasks waiting in a deque, and tasks waiting or running
+		std::atomic<size_t> m_queued = 0;
+		std::atomic<size_t> m_pending = 0;
+		std::atomic<size_t> m_nextQueue = 0;
+		bool m_stopping = false;
+	};
+}
+
+#endif
\ No newline at end of file